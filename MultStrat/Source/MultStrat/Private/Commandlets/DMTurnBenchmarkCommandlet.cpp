@@ -0,0 +1,454 @@
+// Copyright (c) 2025 William Pritz under MIT License
+
+
+#include "Commandlets/DMTurnBenchmarkCommandlet.h"
+
+#include "Commands/DMCommand_BuildShip.h"				// UDMCommand_BuildShip
+#include "Commands/DMCommand_MoveShip.h"				// UDMCommand_MoveShip, FDMMoveShipParams
+#include "Commands/DMCommandQueueSubsystem.h"			// UDMCommandQueueSubsystem, LogCommands
+#include "Components/DMNodeConnectionComponent.h"		// UDMNodeConnectionComponent
+#include "Components/DMTeamComponent.h"					// UDMTeamComponent, LogTeams
+#include "Engine/Engine.h"								// GEngine
+#include "Engine/GameInstance.h"						// UGameInstance
+#include "GalaxyObjects/DMGalaxyNode.h"					// ADMGalaxyNode, LogGalaxy
+#include "GalaxyObjects/DMPlanet.h"						// ADMPlanet
+#include "GalaxyObjects/DMPlanetProcessingSubsystem.h"	// UDMPlanetProcessingSubsystem
+#include "GameSettings/DMGameMode.h"					// ADMGameMode
+#include "GameSettings/DMGameState.h"					// ADMGameState
+#include "Misc/FileHelper.h"							// FFileHelper
+#include "Player/DMPlayerState.h"						// ADMPlayerState
+#include "Player/DMShip.h"								// ADMShip
+
+DEFINE_LOG_CATEGORY_STATIC(LogTurnBenchmark, Log, All);
+
+namespace DMTurnBenchmark
+{
+	static const TCHAR* DefaultGameMode = TEXT("/Game/GameSettings/BP_CommandGamemode.BP_CommandGamemode_C");
+	static const TCHAR* DefaultNodeClass = TEXT("/Game/GalaxyObjects/BP_DMPlanet.BP_DMPlanet_C");
+
+	/** Distance between neighboring nodes in the grid */
+	static constexpr float NodeSpacing = 1000.0f;
+}
+
+/******************************************************************************
+ * Constructor: headless, no editor required
+******************************************************************************/
+UDMTurnBenchmarkCommandlet::UDMTurnBenchmarkCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = true;
+	LogToConsole = true;
+}
+
+/*/////////////////////////////////////////////////////////////////////////////
+*	UCommandlet Interface /////////////////////////////////////////////////////
+*//////////////////////////////////////////////////////////////////////////////
+
+/******************************************************************************
+ * Run the benchmark; returns 0 on success
+******************************************************************************/
+int32 UDMTurnBenchmarkCommandlet::Main(const FString& Params) /* override */
+{
+	int32 NumNodes = 1024;
+	int32 NumShips = 256;
+	int32 NumTurns = 50;
+	int32 NumPlayers = 4;
+	int32 Seed = 1;
+	float MoveChance = 0.8f;
+	float BuildChance = 0.25f;
+	FString CsvPath;
+	FString GameModePath = DMTurnBenchmark::DefaultGameMode;
+	FString NodeClassPath = DMTurnBenchmark::DefaultNodeClass;
+
+	FParse::Value(*Params, TEXT("nodes="), NumNodes);
+	FParse::Value(*Params, TEXT("ships="), NumShips);
+	FParse::Value(*Params, TEXT("turns="), NumTurns);
+	FParse::Value(*Params, TEXT("players="), NumPlayers);
+	FParse::Value(*Params, TEXT("seed="), Seed);
+	FParse::Value(*Params, TEXT("movechance="), MoveChance);
+	FParse::Value(*Params, TEXT("buildchance="), BuildChance);
+	FParse::Value(*Params, TEXT("csv="), CsvPath);
+	FParse::Value(*Params, TEXT("game="), GameModePath);
+	FParse::Value(*Params, TEXT("nodeclass="), NodeClassPath);
+
+	const int32 MaxPlayers = (int32)EDMPlayerTeam::TeamEight - (int32)EDMPlayerTeam::TeamOne + 1;
+	NumNodes = FMath::Max(NumNodes, 1);
+	NumShips = FMath::Clamp(NumShips, 0, NumNodes);
+	NumTurns = FMath::Max(NumTurns, 1);
+	NumPlayers = FMath::Clamp(NumPlayers, 1, MaxPlayers);
+	Random.Initialize(Seed);
+
+	// Per-event logging would dominate the numbers; keep warnings and errors only
+	if (!FParse::Param(*Params, TEXT("verbose")))
+	{
+		LogCommands.SetVerbosity(ELogVerbosity::Warning);
+		LogGalaxy.SetVerbosity(ELogVerbosity::Warning);
+		LogTeams.SetVerbosity(ELogVerbosity::Warning);
+	}
+
+	UClass* NodeClass = LoadClass<ADMGalaxyNode>(nullptr, *NodeClassPath);
+	if (NodeClass == nullptr)
+	{
+		UE_LOG(LogTurnBenchmark, Error, TEXT("Could not load node class %s"), *NodeClassPath)
+		return 1;
+	}
+	if (!NodeClass->IsChildOf(ADMPlanet::StaticClass()))
+	{
+		UE_LOG(LogTurnBenchmark, Warning, TEXT("Node class %s is not a planet; no BuildShip orders will succeed"), *NodeClassPath)
+	}
+
+	UWorld* World = CreateBenchmarkWorld(GameModePath);
+	if (World == nullptr)
+	{
+		return 1;
+	}
+
+	if (!BuildGalaxy(World, NodeClass, NumNodes))
+	{
+		DestroyBenchmarkWorld(World);
+		return 1;
+	}
+
+	// Connectors are built when the nodes begin play
+	World->BeginPlay();
+	PopulateGalaxy(World, NumPlayers, NumShips);
+
+	UE_LOG(LogTurnBenchmark, Display, TEXT("Benchmarking %d turns: %d nodes, %d ships, %d players, seed %d"),
+		NumTurns, NumNodes, NumShips, NumPlayers, Seed)
+
+	TArray<FTurnSample> Samples;
+	Samples.Reserve(NumTurns);
+	for (int32 Turn = 0; Turn < NumTurns; ++Turn)
+	{
+		FTurnSample& Sample = Samples.AddDefaulted_GetRef();
+
+		const double RegisterStart = FPlatformTime::Seconds();
+		Sample.CommandsIssued = IssueRandomOrders(World, MoveChance, BuildChance, Sample.CommandsRegistered);
+		Sample.RegisterMs = (FPlatformTime::Seconds() - RegisterStart) * 1000.0;
+
+		ProcessTurn(World, Sample);
+
+		UE_LOG(LogTurnBenchmark, Display, TEXT("Turn %d: %d/%d commands registered in %.3f ms, execute %.3f ms, resolve %.3f ms (%d ticks)"),
+			Turn,
+			Sample.CommandsRegistered,
+			Sample.CommandsIssued,
+			Sample.RegisterMs,
+			Sample.ExecuteMs,
+			Sample.ResolveMs,
+			Sample.ResolveTicks)
+
+		// Destroyed ships shouldn't pile up across turns; keep GC out of the timings
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	// Summary
+	double TotalExecuteMs = 0.0;
+	double TotalResolveMs = 0.0;
+	double MaxExecuteMs = 0.0;
+	double MaxResolveMs = 0.0;
+	for (const FTurnSample& Sample : Samples)
+	{
+		TotalExecuteMs += Sample.ExecuteMs;
+		TotalResolveMs += Sample.ResolveMs;
+		MaxExecuteMs = FMath::Max(MaxExecuteMs, Sample.ExecuteMs);
+		MaxResolveMs = FMath::Max(MaxResolveMs, Sample.ResolveMs);
+	}
+
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+	UE_LOG(LogTurnBenchmark, Display, TEXT("Execute: avg %.3f ms, max %.3f ms | Resolve: avg %.3f ms, max %.3f ms | Peak memory: %.1f MiB physical, %.1f MiB virtual"),
+		TotalExecuteMs / Samples.Num(),
+		MaxExecuteMs,
+		TotalResolveMs / Samples.Num(),
+		MaxResolveMs,
+		MemoryStats.PeakUsedPhysical / (1024.0 * 1024.0),
+		MemoryStats.PeakUsedVirtual / (1024.0 * 1024.0))
+
+	if (!CsvPath.IsEmpty())
+	{
+		WriteCsv(CsvPath, Samples);
+	}
+
+	DestroyBenchmarkWorld(World);
+	return 0;
+}
+
+/*/////////////////////////////////////////////////////////////////////////////
+*	Benchmark Steps ///////////////////////////////////////////////////////////
+*//////////////////////////////////////////////////////////////////////////////
+
+/******************************************************************************
+ * Spin up a standalone game world running our game mode
+ * The game instance starts with a placeholder world; swap ours in so the game
+ *		mode, game state and subsystems all see a regular game world
+******************************************************************************/
+UWorld* UDMTurnBenchmarkCommandlet::CreateBenchmarkWorld(const FString& GameModePath)
+{
+	GameInstance = NewObject<UGameInstance>(GEngine);
+	GameInstance->InitializeStandalone(TEXT("DMTurnBenchmark"));
+
+	FWorldContext* WorldContext = GameInstance->GetWorldContext();
+	check(WorldContext);
+	UWorld* PlaceholderWorld = WorldContext->World();
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("DMTurnBenchmark"));
+	WorldContext->WorldType = EWorldType::Game;
+	WorldContext->SetCurrentWorld(World);
+	World->SetGameInstance(GameInstance);
+
+	if (PlaceholderWorld != nullptr)
+	{
+		PlaceholderWorld->DestroyWorld(false);
+	}
+
+	FURL URL(nullptr, *FString::Printf(TEXT("DMTurnBenchmark?game=%s"), *GameModePath), TRAVEL_Absolute);
+	if (!World->SetGameMode(URL) || !IsValid(World->GetAuthGameMode<ADMGameMode>()))
+	{
+		UE_LOG(LogTurnBenchmark, Error, TEXT("Could not create an ADMGameMode from %s"), *GameModePath)
+		DestroyBenchmarkWorld(World);
+		return nullptr;
+	}
+
+	World->InitializeActorsForPlay(URL);
+	return World;
+}
+
+/******************************************************************************
+ * Tear down the world made by CreateBenchmarkWorld
+******************************************************************************/
+void UDMTurnBenchmarkCommandlet::DestroyBenchmarkWorld(UWorld* World)
+{
+	Nodes.Empty();
+	Players.Empty();
+	TeamPlayers.Empty();
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	GameInstance = nullptr;
+
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+/******************************************************************************
+ * Spawn a square-ish grid of nodes, each connected to its 4 neighbors
+ * Must run before the world begins play; connectors are built on BeginPlay
+******************************************************************************/
+bool UDMTurnBenchmarkCommandlet::BuildGalaxy(UWorld* World, UClass* NodeClass, int32 NumNodes)
+{
+	const int32 Columns = FMath::Max(1, FMath::CeilToInt(FMath::Sqrt((float)NumNodes)));
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	Nodes.Reserve(NumNodes);
+	for (int32 i = 0; i < NumNodes; ++i)
+	{
+		const FVector Location((i % Columns) * DMTurnBenchmark::NodeSpacing, (i / Columns) * DMTurnBenchmark::NodeSpacing, 0.0f);
+		ADMGalaxyNode* pNode = World->SpawnActor<ADMGalaxyNode>(NodeClass, Location, FRotator::ZeroRotator, SpawnParams);
+		if (!IsValid(pNode))
+		{
+			UE_LOG(LogTurnBenchmark, Error, TEXT("Failed to spawn node %d of class %s"), i, *NodeClass->GetName())
+			return false;
+		}
+		Nodes.Add(pNode);
+	}
+
+	auto Connect = [](ADMGalaxyNode* pFirst, ADMGalaxyNode* pSecond)
+	{
+		pFirst->GetConnectionManager()->ConnectedNodes.Add(pSecond);
+		pSecond->GetConnectionManager()->ConnectedNodes.Add(pFirst);
+	};
+
+	for (int32 i = 0; i < NumNodes; ++i)
+	{
+		if ((i % Columns) + 1 < Columns && i + 1 < NumNodes)
+		{
+			Connect(Nodes[i], Nodes[i + 1]);
+		}
+		if (i + Columns < NumNodes)
+		{
+			Connect(Nodes[i], Nodes[i + Columns]);
+		}
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * Register the players and scatter ships over random nodes
+******************************************************************************/
+void UDMTurnBenchmarkCommandlet::PopulateGalaxy(UWorld* World, int32 NumPlayers, int32 NumShips)
+{
+	ADMGameState* pGameState = World->GetGameState<ADMGameState>();
+	ADMGameMode* pGameMode = World->GetAuthGameMode<ADMGameMode>();
+	check(pGameState && pGameMode)
+
+	for (int32 i = 0; i < NumPlayers; ++i)
+	{
+		ADMPlayerState* pPlayer = World->SpawnActor<ADMPlayerState>();
+		pGameState->RegisterPlayerState(pPlayer);
+		Players.Add(pPlayer);
+		TeamPlayers.Add(pPlayer->TeamComponent->GetTeam(), pPlayer);
+	}
+
+	TSubclassOf<ADMShip> ShipClass = pGameMode->GetDefaultShip();
+	if (ShipClass == nullptr)
+	{
+		UE_LOG(LogTurnBenchmark, Warning, TEXT("Game mode has no default ship; the galaxy starts empty"))
+		return;
+	}
+
+	// Shuffle the nodes so ships land in random places
+	TArray<int32> NodeOrder;
+	NodeOrder.Reserve(Nodes.Num());
+	for (int32 i = 0; i < Nodes.Num(); ++i)
+	{
+		NodeOrder.Add(i);
+	}
+	for (int32 i = NodeOrder.Num() - 1; i > 0; --i)
+	{
+		NodeOrder.Swap(i, Random.RandRange(0, i));
+	}
+
+	for (int32 i = 0; i < NumShips; ++i)
+	{
+		if (ADMPlanet* pPlanet = Cast<ADMPlanet>(Nodes[NodeOrder[i]]))
+		{
+			pPlanet->K2_SpawnShip(ShipClass, Players[i % Players.Num()]->TeamComponent->GetTeam());
+		}
+	}
+}
+
+/******************************************************************************
+ * Queue one turn worth of random orders; returns the # of orders issued
+ * Every ship may move to a random neighbor, and every empty owned planet may
+ *		build a ship. Orders go through the same pool/register path as
+ *		commands arriving from clients.
+******************************************************************************/
+int32 UDMTurnBenchmarkCommandlet::IssueRandomOrders(UWorld* World, float MoveChance, float BuildChance, int32& OutRegistered)
+{
+	UDMCommandQueueSubsystem* pCommandQueue = UDMCommandQueueSubsystem::Get(World);
+	check(pCommandQueue)
+
+	int32 Issued = 0;
+	OutRegistered = 0;
+
+	auto Submit = [pCommandQueue, &Issued, &OutRegistered](UDMCommand* pCommand, bool bInitialized)
+	{
+		++Issued;
+		if (bInitialized && pCommandQueue->RegisterCommand(pCommand))
+		{
+			++OutRegistered;
+		}
+		else
+		{
+			pCommandQueue->ReleaseCommand(pCommand);
+		}
+	};
+
+	for (ADMGalaxyNode* pNode : Nodes)
+	{
+		if (!IsValid(pNode))
+		{
+			continue;
+		}
+
+		if (ADMShip* pShip = pNode->GetShip())
+		{
+			ADMPlayerState** ppPlayer = TeamPlayers.Find(pShip->TeamComponent->GetTeam());
+			const TArray<const ADMGalaxyNode*>& Neighbors = pNode->GetConnectionManager()->ConnectedNodes;
+			if (ppPlayer == nullptr || Neighbors.IsEmpty() || Random.FRand() >= MoveChance)
+			{
+				continue;
+			}
+
+			FDMMoveShipParams MoveParams;
+			MoveParams.RequestingPlayer = *ppPlayer;
+			MoveParams.Target = const_cast<ADMGalaxyNode*>(Neighbors[Random.RandHelper(Neighbors.Num())]);
+			MoveParams.Ship = pShip;
+
+			if (UDMCommand_MoveShip* pMove = Cast<UDMCommand_MoveShip>(pCommandQueue->AcquireCommand(UDMCommand_MoveShip::StaticClass())))
+			{
+				Submit(pMove, pMove->InitializeMoveShip(MoveParams));
+			}
+		}
+		else if (pNode->IsA<ADMPlanet>())
+		{
+			ADMPlayerState** ppPlayer = TeamPlayers.Find(pNode->TeamComponent->GetTeam());
+			if (ppPlayer == nullptr || Random.FRand() >= BuildChance)
+			{
+				continue;
+			}
+
+			FDMCommandParams BuildParams;
+			BuildParams.RequestingPlayer = *ppPlayer;
+			BuildParams.Target = pNode;
+
+			if (UDMCommand* pBuild = pCommandQueue->AcquireCommand(UDMCommand_BuildShip::StaticClass()))
+			{
+				Submit(pBuild, pBuild->InitializeFromParams(BuildParams));
+			}
+		}
+	}
+
+	return Issued;
+}
+
+/******************************************************************************
+ * Execute the queued commands and run planet processing to completion
+ * Planet processing normally spreads over frames; here it is ticked back to
+ *		back so the time is pure processing cost
+******************************************************************************/
+void UDMTurnBenchmarkCommandlet::ProcessTurn(UWorld* World, FTurnSample& OutSample)
+{
+	UDMCommandQueueSubsystem* pCommandQueue = UDMCommandQueueSubsystem::Get(World);
+	UDMPlanetProcessingSubsystem* pPlanetProcessing = UDMPlanetProcessingSubsystem::Get(World);
+	check(pCommandQueue && pPlanetProcessing)
+
+	const double ExecuteStart = FPlatformTime::Seconds();
+	pCommandQueue->ExecuteCommandsForTurn();
+	const double ResolveStart = FPlatformTime::Seconds();
+
+	while (pPlanetProcessing->IsProcessingTurn() && OutSample.ResolveTicks < MaxResolveTicks)
+	{
+		pPlanetProcessing->Tick(0.0f);
+		++OutSample.ResolveTicks;
+	}
+	const double ResolveEnd = FPlatformTime::Seconds();
+
+	if (pPlanetProcessing->IsProcessingTurn())
+	{
+		UE_LOG(LogTurnBenchmark, Error, TEXT("Planet processing did not finish after %d ticks"), OutSample.ResolveTicks)
+	}
+
+	OutSample.ExecuteMs = (ResolveStart - ExecuteStart) * 1000.0;
+	OutSample.ResolveMs = (ResolveEnd - ResolveStart) * 1000.0;
+}
+
+/******************************************************************************
+ * Write per-turn samples to disk
+******************************************************************************/
+void UDMTurnBenchmarkCommandlet::WriteCsv(const FString& CsvPath, const TArray<FTurnSample>& Samples) const
+{
+	FString Csv = TEXT("Turn,CommandsIssued,CommandsRegistered,RegisterMs,ExecuteMs,ResolveMs,ResolveTicks\n");
+	for (int32 Turn = 0; Turn < Samples.Num(); ++Turn)
+	{
+		const FTurnSample& Sample = Samples[Turn];
+		Csv += FString::Printf(TEXT("%d,%d,%d,%.4f,%.4f,%.4f,%d\n"),
+			Turn,
+			Sample.CommandsIssued,
+			Sample.CommandsRegistered,
+			Sample.RegisterMs,
+			Sample.ExecuteMs,
+			Sample.ResolveMs,
+			Sample.ResolveTicks);
+	}
+
+	if (!FFileHelper::SaveStringToFile(Csv, *CsvPath))
+	{
+		UE_LOG(LogTurnBenchmark, Error, TEXT("Failed to write benchmark results to %s"), *CsvPath)
+		return;
+	}
+	UE_LOG(LogTurnBenchmark, Display, TEXT("Benchmark results written to %s"), *CsvPath)
+}
@@ -6,6 +6,7 @@
 #include "Commands/DMCommandQueueSubsystem.h"	// LogCommands
 #include "GalaxyObjects\DMGalaxyNode.h"			// ADMGalaxyNode
 #include "Player/DMPlayerState.h"				// ADMPlayerState
+#include "UObject/CoreNet.h"					// UPackageMap
 
 /*/////////////////////////////////////////////////////////////////////////////
 *	Command Queue Subsystem Functions /////////////////////////////////////////
@@ -21,6 +22,42 @@ bool UDMCommand::RunCommand_Implementation() const
 	return false;
 }
 
+/******************************************************************************
+ * Clear everything set by initialization so the command queue can reuse this object
+******************************************************************************/
+void UDMCommand::ResetCommand()
+{
+	pOwningPlayer = nullptr;
+	pTargetNode = nullptr;
+	Priority = 0;
+	QueueSlot = INDEX_NONE;
+	bPreStaged = false;
+}
+
+/******************************************************************************
+ * Do the order independent part of RunCommand now, while other players are
+ *		still submitting
+******************************************************************************/
+void UDMCommand::PreStage()
+{
+	if (!bPreStaged)
+	{
+		bPreStaged = PreStageCommand();
+	}
+}
+
+/******************************************************************************
+ * Undo anything PreStage did
+******************************************************************************/
+void UDMCommand::RollbackPreStage()
+{
+	if (bPreStaged)
+	{
+		UndoPreStageCommand();
+		bPreStaged = false;
+	}
+}
+
 /*/////////////////////////////////////////////////////////////////////////////
 *	Command Management Functions //////////////////////////////////////////////
 *//////////////////////////////////////////////////////////////////////////////
@@ -32,14 +69,32 @@ bool UDMCommand::RunCommand_Implementation() const
 ******************************************************************************/
 bool UDMCommand::InitializeCommand_Implementation(UDMCommandInit* InitVariables)
 {
-	if (!IsValid(InitVariables) || !IsValid(InitVariables->pRequestingPlayer) 
-								|| !IsValid(InitVariables->pTarget))
+	if (!IsValid(InitVariables))
 	{
 		return false;
 	}
 
-	pOwningPlayer = InitVariables->pRequestingPlayer;
-	pTargetNode = InitVariables->pTarget;
+	FDMCommandParams Params;
+	Params.RequestingPlayer = InitVariables->pRequestingPlayer;
+	Params.Target = InitVariables->pTarget;
+
+	return InitializeFromParams(Params);
+}
+
+/******************************************************************************
+ * Native initialization from plain data; InitializeCommand unpacks its init
+ *		object into this
+ * returns true if the input is valid
+******************************************************************************/
+bool UDMCommand::InitializeFromParams(const FDMCommandParams& Params)
+{
+	if (!IsValid(Params.RequestingPlayer) || !IsValid(Params.Target))
+	{
+		return false;
+	}
+
+	pOwningPlayer = Params.RequestingPlayer;
+	pTargetNode = Params.Target;
 
 	return true;
 }
@@ -54,15 +109,26 @@ bool UDMCommand::Validate_Implementation() const
 }
 
 /******************************************************************************
- * Create a new UObject of this command's class type and copy the data from command data into it
+ * Get a UObject of this command's class type from the command pool and copy 
+ *		the data from command data into it
  * Used when sending commands from the client to the server instead of replication so that we
  *		don't have to wait for unreal's automatic replication to copy the data over for us;
  *		not all clients need a copy of the command, just the server.
 ******************************************************************************/
-UDMCommand* UDMCommand::CopyCommand(const FCommandPacket& Packet)
+UDMCommand* UDMCommand::CopyCommand(const FCommandPacket& Packet, UDMCommandQueueSubsystem* pCommandPool) const
 {
-	UDMCommand* pNewCommand = NewObject<UDMCommand>();
-	pNewCommand->GetCopyCommandData(Packet.Data);
+	if (!IsValid(pCommandPool))
+	{
+		UE_LOG(LogCommands, Error, TEXT("UDMCommand::CopyCommand: No command pool to copy class %s into"),
+			*GetClass()->GetName())
+		return nullptr;
+	}
+
+	UDMCommand* pNewCommand = pCommandPool->AcquireCommand(GetClass());
+	if (pNewCommand != nullptr)
+	{
+		pNewCommand->GetCopyCommandData(Packet.Data);
+	}
 
 	return pNewCommand;
 }
@@ -98,4 +164,145 @@ void FCommandPacket::InitializePacket(UDMCommand* CommandForInfo)
 {
 	CommandClass = CommandForInfo->GetClass();
 	CommandForInfo->FillCopyCommandData(Data);
-}
\ No newline at end of file
+}
+
+/******************************************************************************
+ * Custom replication for a full turn of commands
+ * Layout: class table, object table, then per packet a class index and one
+ *		object index per piece of data. Indices are bit-packed to the size of
+ *		their table; object index 0 is reserved for nullptr.
+******************************************************************************/
+bool FCommandTurnPacket::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = true;
+	if (Map == nullptr)
+	{
+		UE_LOG(LogCommands, Error, TEXT("FCommandTurnPacket::NetSerialize: No package map; command packets can only be sent over the network"))
+		bOutSuccess = false;
+		return false;
+	}
+
+	TArray<UObject*> ClassTable;
+	TArray<UObject*> ObjectTable;
+	TMap<UObject*, uint32> ClassIndices;
+	TMap<UObject*, uint32> ObjectIndices;
+
+	// Build the tables from our packets before writing anything
+	if (Ar.IsSaving())
+	{
+		for (const FCommandPacket& Packet : Packets)
+		{
+			UObject* pClass = Packet.CommandClass.Get();
+			if (!ClassIndices.Contains(pClass))
+			{
+				ClassIndices.Add(pClass, ClassTable.Add(pClass));
+			}
+
+			for (UObject* pData : Packet.Data)
+			{
+				if (pData != nullptr && !ObjectIndices.Contains(pData))
+				{
+					ObjectIndices.Add(pData, ObjectTable.Add(pData));
+				}
+			}
+		}
+	}
+
+	// Class table
+	uint32 NumClasses = ClassTable.Num();
+	Ar.SerializeIntPacked(NumClasses);
+	if (Ar.IsLoading())
+	{
+		if (NumClasses > MaxPackets)
+		{
+			Ar.SetError();
+			bOutSuccess = false;
+			return false;
+		}
+		ClassTable.SetNumZeroed(NumClasses);
+	}
+	for (UObject*& pClass : ClassTable)
+	{
+		Map->SerializeObject(Ar, UClass::StaticClass(), pClass);
+	}
+
+	// Object table
+	uint32 NumObjects = ObjectTable.Num();
+	Ar.SerializeIntPacked(NumObjects);
+	if (Ar.IsLoading())
+	{
+		if (NumObjects > MaxPackets * MaxDataPerPacket)
+		{
+			Ar.SetError();
+			bOutSuccess = false;
+			return false;
+		}
+		ObjectTable.SetNumZeroed(NumObjects);
+	}
+	for (UObject*& pObject : ObjectTable)
+	{
+		// Unmapped objects come through as nullptr; the server's Validate will reject those commands
+		Map->SerializeObject(Ar, UObject::StaticClass(), pObject);
+	}
+
+	// Packets
+	uint32 NumPackets = Packets.Num();
+	Ar.SerializeIntPacked(NumPackets);
+	if (Ar.IsLoading())
+	{
+		if (NumPackets > MaxPackets || (NumPackets > 0 && NumClasses == 0))
+		{
+			Ar.SetError();
+			bOutSuccess = false;
+			return false;
+		}
+		Packets.SetNum(NumPackets);
+	}
+
+	for (FCommandPacket& Packet : Packets)
+	{
+		uint32 ClassIndex = 0;
+		if (Ar.IsSaving())
+		{
+			ClassIndex = ClassIndices.FindChecked(Packet.CommandClass.Get());
+		}
+		Ar.SerializeInt(ClassIndex, FMath::Max<uint32>(NumClasses, 1));
+
+		uint32 NumData = Packet.Data.Num();
+		if (Ar.IsSaving() && !ensureMsgf(NumData <= MaxDataPerPacket, TEXT("Command %s has too much data to send"), *GetNameSafe(Packet.CommandClass)))
+		{
+			Ar.SetError();
+			bOutSuccess = false;
+			return false;
+		}
+		Ar.SerializeInt(NumData, MaxDataPerPacket + 1);
+
+		if (Ar.IsLoading())
+		{
+			UClass* pClass = Cast<UClass>(ClassTable[ClassIndex]);
+			Packet.CommandClass = (pClass != nullptr && pClass->IsChildOf(UDMCommand::StaticClass())) ? pClass : nullptr;
+			Packet.Data.SetNum(NumData);
+		}
+
+		for (TObjectPtr<UObject>& pData : Packet.Data)
+		{
+			uint32 ObjectIndex = 0;
+			if (Ar.IsSaving() && pData != nullptr)
+			{
+				ObjectIndex = ObjectIndices.FindChecked(pData.Get()) + 1;
+			}
+			Ar.SerializeInt(ObjectIndex, NumObjects + 1);
+
+			if (Ar.IsLoading())
+			{
+				pData = ObjectIndex > 0 ? ObjectTable[ObjectIndex - 1] : nullptr;
+			}
+		}
+	}
+
+	if (Ar.IsError())
+	{
+		bOutSuccess = false;
+	}
+	return bOutSuccess;
+}
@@ -3,29 +3,37 @@
 
 #include "Commands/DMCommandQueueSubsystem.h"
 
+#include "Async/ParallelFor.h"							// ParallelFor
 #include "Commands/DMCommand.h"							// UDMCommand
 #include "GalaxyObjects/DMPlanetProcessingSubsystem.h"	// UDMPlanetProcessingSubsystem
 #include "GameSettings/DMGameMode.h"					// ADMGameMode
 #include "GameSettings/DMGameState.h"					// ADMGameState
+#include "GameSettings/DMTurnEventLog.h"				// FDMTurnEventLog
+#include "GameSettings/DMTurnTrace.h"					// DM_TURN_TRACE_SCOPE
 #include "Components/DMTeamComponent.h"					// EDMPlayerTeam
 #include "Player/DMPlayerState.h"						// ADMPlayerState
 
 DEFINE_LOG_CATEGORY(LogCommands);
 
 /******************************************************************************
- * UWorldSubsystem override; only build this subsystem on the server
- * https://forums.unrealengine.com/t/subsystem-only-on-server/645021/5
+ * UWorldSubsystem override; build this subsystem on every game world
+ * Clients need it to run commands in lockstep; whether lockstep is on isn't
+ *		known until the game state replicates, so always create it
 ******************************************************************************/
 bool UDMCommandQueueSubsystem::ShouldCreateSubsystem(UObject* Outer) const /* override */
 {
-	if (!Super::ShouldCreateSubsystem(Outer))
-	{
-		return false;
-	}
+	return Super::ShouldCreateSubsystem(Outer);
+}
+
+/******************************************************************************
+ * UWorldSubsystem override; hand anything still buffered to the log before
+ *		the world goes away
+******************************************************************************/
+void UDMCommandQueueSubsystem::Deinitialize() /* override */
+{
+	EventLog.Flush();
 
-	UWorld* pWorld = Cast<UWorld>(Outer);
-	// will be created in standalone, dedicated servers, and listen servers
-	return pWorld->GetNetMode() < NM_Client; 
+	Super::Deinitialize();
 }
 
 /******************************************************************************
@@ -49,43 +57,141 @@ UDMCommandQueueSubsystem* UDMCommandQueueSubsystem::Get(UObject* WorldContextObj
 ******************************************************************************/
 void UDMCommandQueueSubsystem::ExecuteCommandsForTurn()
 {
-	// Higher priority commands first
-	ActiveCommands.Sort([](const UDMCommand& first, const UDMCommand& second)
+	DM_TURN_TRACE_SCOPE(ExecuteCommandsForTurn);
+	DM_TURN_TRACE_RESET_COUNTERS();
+
+	// Higher priority commands first; buckets are already in priority order
+	// Note: buckets are emptied here, but nothing can garbage collect the commands before this function returns
+	TArray<UDMCommand*> TurnCommands;
 	{
-		return first.Priority > second.Priority;
-	});
+		DM_TURN_TRACE_SCOPE(PriorityOrder);
+		for (int32 Priority = NumPriorityBuckets - 1; Priority >= 0; --Priority)
+		{
+			TArray<TObjectPtr<UDMCommand>>& BucketCommands = PriorityBuckets[Priority].Commands;
+			for (UDMCommand* Command : BucketCommands)
+			{
+				// cancelled commands leave an empty slot behind
+				if (Command != nullptr)
+				{
+					Command->QueueSlot = INDEX_NONE;
+					TurnCommands.Add(Command);
+				}
+			}
+
+			// prepare for next turn; keep the allocation, the bucket will likely be used again
+			BucketCommands.Reset();
+		}
+		PlayerCommands.Reset();
+	}
+
+	RunTurnCommands(TurnCommands);
+}
+
+/******************************************************************************
+ * Lockstep clients: run the commands the server ran this turn, in the same
+ *		order, then resolve planets locally
+ * 
+ * Client Function
+******************************************************************************/
+void UDMCommandQueueSubsystem::ExecuteLockstepTurn(const FCommandTurnPacket& TurnPacket)
+{
+	DM_TURN_TRACE_SCOPE(ExecuteLockstepTurn);
+	DM_TURN_TRACE_RESET_COUNTERS();
+
+	// Commands have to see the galaxy exactly as the server did, so last turn has to be done resolving
+	UDMPlanetProcessingSubsystem* pPlanetProcessing = UDMPlanetProcessingSubsystem::Get(this);
+	ensure(pPlanetProcessing);
+	if (IsValid(pPlanetProcessing))
+	{
+		pPlanetProcessing->FinishProcessingTurn();
+	}
 
-	// Run + Debug print
-	for (UDMCommand* Command : ActiveCommands)
+	TArray<UDMCommand*> TurnCommands;
+	TurnCommands.Reserve(TurnPacket.Packets.Num());
+	for (const FCommandPacket& Packet : TurnPacket.Packets)
 	{
-		if (!IsValid(Command) || !Command->Validate())
+		const UDMCommand* pCommandCDO = Packet.CommandClass != nullptr ? Packet.CommandClass->GetDefaultObject<UDMCommand>() : nullptr;
+		UDMCommand* pCommand = pCommandCDO != nullptr ? pCommandCDO->CopyCommand(Packet, this) : nullptr;
+		if (pCommand != nullptr)
+		{
+			TurnCommands.Add(pCommand);
+		}
+		else
+		{
+			UE_LOG(LogCommands, Error, TEXT("UDMCommandQueueSubsystem::ExecuteLockstepTurn: Could not copy a command of class %s; this client will desync"),
+				*GetNameSafe(Packet.CommandClass))
+		}
+	}
+
+	RunTurnCommands(TurnCommands);
+}
+
+/******************************************************************************
+ * Validate, then run the turn's commands in order, return them to the pool
+ *		and start planet processing
+******************************************************************************/
+void UDMCommandQueueSubsystem::RunTurnCommands(const TArray<UDMCommand*>& TurnCommands)
+{
+	// Phase 1: validate every command against the galaxy as it was before any command ran
+	TArray<bool> CommandValid;
+	ValidateCommands(TurnCommands, CommandValid);
+
+	// Lockstep: clients run the survivors themselves; send them before any of them change the galaxy
+	// (ships are sent by the node they're docked at)
+	ADMGameState* pDMState = ADMGameState::Get(this);
+	if (IsValid(pDMState) && pDMState->HasAuthority() && pDMState->bLockstepTurns)
+	{
+		DM_TURN_TRACE_SCOPE(SendLockstepCommands);
+
+		FCommandTurnPacket TurnPacket;
+		TurnPacket.Packets.Reserve(TurnCommands.Num());
+		for (int32 i = 0; i < TurnCommands.Num(); ++i)
+		{
+			if (CommandValid[i])
+			{
+				TurnPacket.Packets.AddDefaulted_GetRef().InitializePacket(TurnCommands[i]);
+			}
+		}
+		pDMState->MulticastTurnCommands(pDMState->GetTurnNumber(), TurnPacket);
+	}
+
+	// Phase 2: Run + Debug print the survivors, in priority order
+	for (int32 i = 0; i < TurnCommands.Num(); ++i)
+	{
+		UDMCommand* Command = TurnCommands[i];
+		if (!CommandValid[i])
 		{
 			UE_LOG(LogCommands, Warning, TEXT("Command %s tried to run but has been invalidated since its registration (%s)"), 
 				IsValid(Command) ? *Command->GetName() : *FString("NULLCLASS"),
 				IsValid(Command) ? *Command->CommandDebug() : *FString("NULLCLASS"))
+			TRACE_COUNTER_INCREMENT(DMTurn_CommandsInvalidated);
+			if (IsValid(Command))
+			{
+				Command->RollbackPreStage();
+			}
 			continue;
 		}
 
-		EDMPlayerTeam PlayerTeam = UDMTeamComponent::GetActorsTeam(Command->GetOwningPlayer());
-		FString EnumName = StaticEnum<EDMPlayerTeam>()->GetAuthoredNameStringByIndex((int32)PlayerTeam);
-		UE_LOG(LogCommands, Display, TEXT("Executing Command from player %s on team %s: %s"), 
-			*Command->GetOwningPlayer()->GetName(), 
-			*EnumName, 
-			*Command->CommandDebug())
+		EventLog.RecordCommand(EDMTurnEventType::CommandExecuted, Command);
 
+		DM_TURN_TRACE_SCOPE(RunCommand);
 		Command->RunCommand();
+		TRACE_COUNTER_INCREMENT(DMTurn_CommandsRun);
 	}
 
-	// prepare for next turn
-	ActiveCommands.Empty();
+	// Commands are done for the turn; keep the objects around for the next one
+	for (UDMCommand* Command : TurnCommands)
+	{
+		ReleaseCommand(Command);
+	}
 
-	//ADMGameState* pDMState = ADMGameState::Get(this);
-	//ensure(pDMState);
+	// Hand this turn's command events to the log
+	EventLog.Flush();
 
-	// DMTODO: we should have this happen locally on every machine
-	UDMPlanetProcessingSubsystem* CommandQueue = UDMPlanetProcessingSubsystem::Get(this);
-	ensure(CommandQueue);
-	CommandQueue->StartProcessingPlanetResults();
+	// In lockstep, every machine resolves the planets locally; otherwise the results replicate from the server
+	UDMPlanetProcessingSubsystem* pPlanetProcessing = UDMPlanetProcessingSubsystem::Get(this);
+	ensure(pPlanetProcessing);
+	pPlanetProcessing->StartProcessingPlanetResults();
 }
 
 /******************************************************************************
@@ -94,6 +200,8 @@ void UDMCommandQueueSubsystem::ExecuteCommandsForTurn()
 ******************************************************************************/
 bool UDMCommandQueueSubsystem::RegisterCommand(UDMCommand* Command)
 {
+	DM_TURN_TRACE_SCOPE(RegisterCommand);
+
 	if (!IsValid(Command))
 	{
 		UE_LOG(LogCommands, Warning, TEXT("UDMCommandQueueSubsystem::RegisterCommand: Null Command Requested!"))
@@ -104,6 +212,12 @@ bool UDMCommandQueueSubsystem::RegisterCommand(UDMCommand* Command)
 		UE_LOG(LogCommands, Warning, TEXT("UDMCommandQueueSubsystem::RegisterCommand: Command Invalid! (Was it initialized properly?)"))
 		return false;
 	}
+	if (Command->QueueSlot != INDEX_NONE)
+	{
+		UE_LOG(LogCommands, Warning, TEXT("UDMCommandQueueSubsystem::RegisterCommand: Command %s is already registered!"),
+			*Command->CommandDebug())
+		return false;
+	}
 
 	// get the priority for the command set properly
 	UWorld* World = GetWorld();
@@ -116,11 +230,18 @@ bool UDMCommandQueueSubsystem::RegisterCommand(UDMCommand* Command)
 
 
 	// register with subsystem
-	ActiveCommands.Add(Command);
+	Command->QueueSlot = PriorityBuckets[Command->Priority].Commands.Add(Command);
+	PlayerCommands.FindOrAdd(Command->GetOwningPlayer()).Add(Command);
 
-	UE_LOG(LogCommands, Display, TEXT("Command for player %s registered (%s)"), 
-			*Command->GetOwningPlayer()->GetName(), 
-			*Command->CommandDebug())
+	// Get the order independent work done while other players are still submitting;
+	// the galaxy is still being resolved while planets process, so leave it all for execution then
+	UDMPlanetProcessingSubsystem* pPlanetProcessing = UDMPlanetProcessingSubsystem::Get(this);
+	if (!IsValid(pPlanetProcessing) || !pPlanetProcessing->IsProcessingTurn())
+	{
+		Command->PreStage();
+	}
+
+	EventLog.RecordCommand(EDMTurnEventType::CommandRegistered, Command, Command->Priority);
 
 	return true;
 }
@@ -132,41 +253,120 @@ bool UDMCommandQueueSubsystem::RegisterCommand(UDMCommand* Command)
 ******************************************************************************/
 void UDMCommandQueueSubsystem::CancelCommands_Implementation(const ADMPlayerState* Player)
 {
-	bool bFoundPlayer = false;
-	size_t PlayerStartPos = 0;
-	size_t PlayerEndPos = ActiveCommands.Num();
-	for (size_t i = 0; i < ActiveCommands.Num() ; ++i)
+	TArray<UDMCommand*> CancelledCommands;
+	if (!PlayerCommands.RemoveAndCopyValue(Player, CancelledCommands) || CancelledCommands.IsEmpty())
 	{
-		if (ActiveCommands[i]->GetOwningPlayer() == Player)
-		{
-			if (!bFoundPlayer)
-			{
-				bFoundPlayer = true;
-				PlayerStartPos = i;
-			}
+		EventLog.Record(EDMTurnEventType::CommandsCancelled, UDMTeamComponent::GetActorsTeam(Player), Player);
+		return;
+	}
 
-			UE_LOG(LogCommands, Display, TEXT("Player %s is trying to cancel Command %s"), 
-				*Player->GetName(),
-				*ActiveCommands[i]->CommandDebug())
-		}
-		else if (bFoundPlayer)
+	// Clear each command's slot in its bucket; nothing else in the bucket moves
+	for (UDMCommand* Command : CancelledCommands)
+	{
+		EventLog.RecordCommand(EDMTurnEventType::CommandCancelled, Command);
+
+		PriorityBuckets[Command->Priority].Commands[Command->QueueSlot] = nullptr;
+		Command->QueueSlot = INDEX_NONE;
+		Command->RollbackPreStage();
+		ReleaseCommand(Command);
+	}
+
+	EventLog.Record(EDMTurnEventType::CommandsCancelled,
+		UDMTeamComponent::GetActorsTeam(Player),
+		Player,
+		nullptr,
+		nullptr,
+		CancelledCommands.Num());
+}
+
+/*/////////////////////////////////////////////////////////////////////////////
+*	Command Pooling ///////////////////////////////////////////////////////////
+*//////////////////////////////////////////////////////////////////////////////
+
+/******************************************************************************
+ * Get a command of the given class to fill with data; reuses a pooled command
+ *		when one is available
+ * Commands from the pool are owned by this subsystem and are returned to the
+ *		pool once they run or are cancelled
+******************************************************************************/
+UDMCommand* UDMCommandQueueSubsystem::AcquireCommand(TSubclassOf<UDMCommand> CommandClass)
+{
+	if (CommandClass == nullptr || CommandClass->HasAnyClassFlags(CLASS_Abstract))
+	{
+		UE_LOG(LogCommands, Error, TEXT("UDMCommandQueueSubsystem::AcquireCommand: Can't make a command of class %s"),
+			*GetNameSafe(CommandClass))
+		return nullptr;
+	}
+
+	if (FDMCommandBucket* pPool = CommandPools.Find(CommandClass))
+	{
+		if (!pPool->Commands.IsEmpty())
 		{
-			PlayerEndPos = i;
-			break;
+			return pPool->Commands.Pop(EAllowShrinking::No);
 		}
 	}
 
-	// DMTODO turn ActiveCommands to LinkedList for cleaner removal
-	if (bFoundPlayer)
+	return NewObject<UDMCommand>(this, CommandClass);
+}
+
+/******************************************************************************
+ * Reset a command and return it to the pool for a future turn
+ * Commands not created by AcquireCommand are ignored and left for garbage
+ *		collection
+******************************************************************************/
+void UDMCommandQueueSubsystem::ReleaseCommand(UDMCommand* Command)
+{
+	if (!IsValid(Command) || Command->GetOuter() != this)
 	{
-		ActiveCommands.RemoveAt(PlayerStartPos, PlayerEndPos - PlayerStartPos, EAllowShrinking::Yes);
-		UE_LOG(LogCommands, Display, TEXT("Player %s cancelled %d Commands"),
-			*Player->GetName(),
-			PlayerEndPos - PlayerStartPos)
+		return;
 	}
-	else
+
+	Command->ResetCommand();
+	CommandPools.FindOrAdd(Command->GetClass()).Commands.Add(Command);
+}
+
+/*/////////////////////////////////////////////////////////////////////////////
+*	Internal Functions ////////////////////////////////////////////////////////
+*//////////////////////////////////////////////////////////////////////////////
+
+/******************************************************************************
+ * Run Validate on every command before any of them execute
+ * Natively validated commands only read the galaxy, so they are validated in
+ *		parallel; commands with a blueprint Validate run on the game thread.
+ * OutValid[i] is true if Commands[i] can be run
+******************************************************************************/
+void UDMCommandQueueSubsystem::ValidateCommands(const TArray<UDMCommand*>& Commands, TArray<bool>& OutValid) const
+{
+	DM_TURN_TRACE_SCOPE(ValidateCommands);
+
+	OutValid.Init(false, Commands.Num());
+
+	// Blueprint overrides have to go through the script VM, which is game thread only
+	TArray<int32> NativeCommands;
+	NativeCommands.Reserve(Commands.Num());
+	for (int32 i = 0; i < Commands.Num(); ++i)
 	{
-		UE_LOG(LogCommands, Display, TEXT("Player %s tried to cancel all their commands, but had no commands queued"),
-			*Player->GetName())
+		UDMCommand* Command = Commands[i];
+		if (!IsValid(Command))
+		{
+			continue;
+		}
+
+		const UFunction* ValidateFunction = Command->FindFunction(GET_FUNCTION_NAME_CHECKED(UDMCommand, Validate));
+		if (ValidateFunction != nullptr && ValidateFunction->GetOwnerClass()->HasAnyClassFlags(CLASS_Native))
+		{
+			NativeCommands.Add(i);
+		}
+		else
+		{
+			OutValid[i] = Command->Validate();
+		}
 	}
-}
\ No newline at end of file
+
+	// Each task writes its own slot, so no locking is needed
+	ParallelFor(TEXT("DMValidateCommands"), NativeCommands.Num(), ValidationBatchSize, [&Commands, &NativeCommands, &OutValid](int32 Index)
+	{
+		const int32 CommandIndex = NativeCommands[Index];
+		OutValid[CommandIndex] = Commands[CommandIndex]->Validate_Implementation();
+	});
+}
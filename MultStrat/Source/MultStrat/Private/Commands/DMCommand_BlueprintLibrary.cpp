@@ -84,18 +84,17 @@ bool UDMCommand_BlueprintLibrary::TrialCommand_BuildShip(const ADMPlayerState* p
 ******************************************************************************/
 UDMCommand_BuildShip* UDMCommand_BlueprintLibrary::MakeCommand_BuildShip(ADMPlayerState* pRequestingPlayer, ADMGalaxyNode* pPlanetToBuildOn)
 {
-	// Can we?
+	FDMCommandParams Params;
+	Params.RequestingPlayer = pRequestingPlayer;
+	Params.Target = pPlanetToBuildOn;
+
 	FString FailureOutput;
-	if (!TrialCommand_BuildShip(pRequestingPlayer, pPlanetToBuildOn, FailureOutput))
+	UDMCommand_BuildShip* NewBuildCommand = BuildCommand_BuildShip(Params, &FailureOutput);
+	if (NewBuildCommand == nullptr)
 	{
 		UE_LOG(LogCommands, Warning, TEXT("UDMCommand_BlueprintLibrary::MakeCommand_BuildShip: %s"), *FailureOutput)
-		return nullptr;
 	}
 
-	// Build it
-	UDMCommand_BuildShip* NewBuildCommand = NewObject<UDMCommand_BuildShip>();
-	NewBuildCommand->InitializeCommand(MakeCommandInit(pRequestingPlayer, pPlanetToBuildOn));
-
 	return NewBuildCommand;
 }
 
@@ -123,7 +122,7 @@ bool UDMCommand_BlueprintLibrary::TrialCommand_MoveShip(const ADMPlayerState* pR
 		return false;
 	}
 	// Ship must be valid
-	if (!IsValid(pShip))
+	if (!IsValid(pShip) || !pShip->IsShipActive())
 	{
 		OutFailString = TEXT("Invalid Ship passed in");
 		return false;
@@ -152,16 +151,71 @@ bool UDMCommand_BlueprintLibrary::TrialCommand_MoveShip(const ADMPlayerState* pR
 ******************************************************************************/
 UDMCommand_MoveShip* UDMCommand_BlueprintLibrary::MakeCommand_MoveShip(ADMPlayerState* pRequestingPlayer, ADMShip* pShip, ADMGalaxyNode* pNodeToMoveTo)
 {
-	// Can we?
+	FDMMoveShipParams Params;
+	Params.RequestingPlayer = pRequestingPlayer;
+	Params.Target = pNodeToMoveTo;
+	Params.Ship = pShip;
+
 	FString FailureOutput;
-	if (!TrialCommand_MoveShip(pRequestingPlayer, pShip, pNodeToMoveTo, FailureOutput))
+	UDMCommand_MoveShip* NewMoveCommand = BuildCommand_MoveShip(Params, &FailureOutput);
+	if (NewMoveCommand == nullptr)
 	{
 		UE_LOG(LogCommands, Warning, TEXT("UDMCommand_BlueprintLibrary::MakeCommand_MoveShip: %s"), *FailureOutput)
+	}
+
+	return NewMoveCommand;
+}
+
+/*/////////////////////////////////////////////////////////////////////////////
+*	Native Construction ///////////////////////////////////////////////////////
+*//////////////////////////////////////////////////////////////////////////////
+
+/******************************************************************************
+ * Build the BuildShip command straight from plain data
+ * returns the constructed command, or a nullptr if the command isn't possible
+ *		(OutFailString is filled with the reason if it was passed in)
+******************************************************************************/
+UDMCommand_BuildShip* UDMCommand_BlueprintLibrary::BuildCommand_BuildShip(const FDMCommandParams& Params, FString* OutFailString)
+{
+	// Can we?
+	FString FailureOutput;
+	if (!TrialCommand_BuildShip(Params.RequestingPlayer, Params.Target, FailureOutput))
+	{
+		if (OutFailString != nullptr)
+		{
+			*OutFailString = MoveTemp(FailureOutput);
+		}
+		return nullptr;
+	}
+
+	// Build it
+	UDMCommand_BuildShip* NewBuildCommand = NewObject<UDMCommand_BuildShip>();
+	NewBuildCommand->InitializeFromParams(Params);
+
+	return NewBuildCommand;
+}
+
+/******************************************************************************
+ * Build the MoveShip command straight from plain data
+ * returns the constructed command, or a nullptr if the command isn't possible
+ *		(OutFailString is filled with the reason if it was passed in)
+******************************************************************************/
+UDMCommand_MoveShip* UDMCommand_BlueprintLibrary::BuildCommand_MoveShip(const FDMMoveShipParams& Params, FString* OutFailString)
+{
+	// Can we?
+	FString FailureOutput;
+	if (!TrialCommand_MoveShip(Params.RequestingPlayer, Params.Ship, Params.Target, FailureOutput))
+	{
+		if (OutFailString != nullptr)
+		{
+			*OutFailString = MoveTemp(FailureOutput);
+		}
 		return nullptr;
 	}
 
 	// Build it
 	UDMCommand_MoveShip* NewMoveCommand = NewObject<UDMCommand_MoveShip>();
-	NewMoveCommand->InitializeCommand(MakeCommandInit_MoveShip(pRequestingPlayer, pNodeToMoveTo, pShip));
+	NewMoveCommand->InitializeMoveShip(Params);
+
 	return NewMoveCommand;
 }
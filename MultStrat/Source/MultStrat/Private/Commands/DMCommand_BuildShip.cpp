@@ -9,7 +9,7 @@
 #include "Components/DMTeamComponent.h"			// UDMTeamComponent
 #include "GalaxyObjects/DMGalaxyNode.h"			// ADMGalaxyNode
 #include "GalaxyObjects/DMPlanet.h"				// ADMPlanet
-#include "GameSettings/DMGameMode.h"			// ADMGameMode
+#include "GameSettings/DMGameState.h"			// ADMGameState
 #include "Player/DMPlayerState.h"				// ADMPlayerState
 #include "Player/DMShip.h"						// ADMShip
 
@@ -32,14 +32,11 @@ UDMCommand_BuildShip::UDMCommand_BuildShip(const FObjectInitializer& ObjectIniti
 ******************************************************************************/
 bool UDMCommand_BuildShip::RunCommand_Implementation() const /* override */
 { 
-	// Get the gamemode 
-	// DMTODO: We have to be able to simulate on clients, who wont have access to this. Pointer to gamestate.
-	UWorld* NodeWorld = pTargetNode->GetWorld();
-	AGameModeBase* GameMode = NodeWorld->GetAuthGameMode();
-	ADMGameMode* DMGameMode = Cast<ADMGameMode>(GameMode);
-	if (!IsValid(DMGameMode))
+	// Get the gamestate; lockstep clients run this too, and they don't have a gamemode
+	ADMGameState* DMGameState = ADMGameState::Get(pTargetNode);
+	if (!IsValid(DMGameState))
 	{
-		UE_LOG(LogCommands, Error, TEXT("UDMCommand_BuildShip::RunCommand: Tried to build ship, but Gamemode inaccessible; did a client run RunCommand?"))
+		UE_LOG(LogCommands, Error, TEXT("UDMCommand_BuildShip::RunCommand: Tried to build ship, but Gamestate inaccessible"))
 		
 		return false;
 	}
@@ -62,7 +59,7 @@ bool UDMCommand_BuildShip::RunCommand_Implementation() const /* override */
 	}
 
 	// make the ship! note: pass in the owning players team instead of using the planet just in case we do some crazy abilities later
-	pTargetPlanet->K2_SpawnShip(DMGameMode->GetDefaultShip(), pOwningPlayer->TeamComponent->GetTeam());
+	pTargetPlanet->SpawnShip(DMGameState->GetDefaultShip(), pOwningPlayer->TeamComponent->GetTeam());
 	return true;
 }
 
@@ -120,15 +117,3 @@ FString UDMCommand_BuildShip::CommandDebug_Implementation() const /* override */
 		IsValid(pOwningPlayer) ? *pOwningPlayer->GetName() : *FString("INVALID PLAYER"), 
 		IsValid(pTargetNode)   ? *pTargetNode->GetName()   : *FString("INVALID TARGET"));
 }
-
-/******************************************************************************
- * returns a string with the name of the command, what it does, and what it
- *		will operate on
-******************************************************************************/
-UDMCommand* UDMCommand_BuildShip::CopyCommand(const FCommandPacket& Packet) /* override */
-{
-	UDMCommand_BuildShip* pNewCommand = NewObject<UDMCommand_BuildShip>();
-	pNewCommand->GetCopyCommandData(Packet.Data);
-
-	return pNewCommand;
-}
@@ -30,7 +30,6 @@ UDMCommand_MoveShip::UDMCommand_MoveShip(const FObjectInitializer& ObjectInitial
 ******************************************************************************/
 bool UDMCommand_MoveShip::RunCommand_Implementation() const /* override */
 {
-	// DMTODO: Hey, what happens if two ships are trying to move from planet A to B, and from B to A?
 	if (!IsValid(pTargetNode) || !IsValid(pShip))
 	{
 		return false;
@@ -38,16 +37,25 @@ bool UDMCommand_MoveShip::RunCommand_Implementation() const /* override */
 
 	if (ADMGalaxyNode* pCurrentNode = pShip->GetCurrentNode())
 	{
+		// Both directions of a connection share one reserved edge, so ships swapping A to B and B to A bounce off each other
 		if (!pCurrentNode->ReserveTraversalTo(pTargetNode, pShip))
 		{
+			// We bounced; the target was told we were coming when we registered
+			if (IsPreStaged())
+			{
+				pTargetNode->RemovePendingShip(pShip);
+				pShip->CommandsComponent->RemoveCommandFlags(ECommandFlags::MovingShip);
+			}
 			return false;
 		}
 	}
 
-
-	pShip->CommandsComponent->AddCommandFlags(ECommandFlags::MovingShip);
-
-	pTargetNode->AddPendingShip(pShip, false, this);
+	// Only the connector reservation above depends on command order; the rest may already be done
+	if (!IsPreStaged())
+	{
+		pShip->CommandsComponent->AddCommandFlags(ECommandFlags::MovingShip);
+		pTargetNode->AddPendingShip(pShip, false, this);
+	}
 
 	return true;
 }
@@ -86,13 +94,33 @@ void UDMCommand_MoveShip::CommandUnqueued_Implementation() /* override */
 bool UDMCommand_MoveShip::InitializeCommand_Implementation(UDMCommandInit* InitVariables)
 {
 	UDMCommandInitMoveShip* InitMove = Cast<UDMCommandInitMoveShip>(InitVariables);
-	if (!IsValid(InitMove) || !IsValid(InitMove->pShip))
+	if (!IsValid(InitMove))
 	{
 		return false;
 	}
-	pShip = InitMove->pShip;
 
-	return Super::InitializeCommand_Implementation(InitVariables);
+	FDMMoveShipParams Params;
+	Params.RequestingPlayer = InitMove->pRequestingPlayer;
+	Params.Target = InitMove->pTarget;
+	Params.Ship = InitMove->pShip;
+
+	return InitializeMoveShip(Params);
+}
+
+/******************************************************************************
+ * Native initialization from plain data; InitializeCommand unpacks its init
+ *		object into this
+ * returns whether init was successful
+******************************************************************************/
+bool UDMCommand_MoveShip::InitializeMoveShip(const FDMMoveShipParams& Params)
+{
+	if (!IsValid(Params.Ship))
+	{
+		return false;
+	}
+	pShip = Params.Ship;
+
+	return InitializeFromParams(Params);
 }
 
 /******************************************************************************
@@ -107,8 +135,8 @@ bool UDMCommand_MoveShip::Validate_Implementation() const /* override */
 		return false;
 	}
 
-	// Its our ship, right?
-	if (!IsValid(pShip) || !pOwningPlayer->TeamComponent->IsSameTeam(pShip->TeamComponent))
+	// Its our ship, right? (and it wasn't lost and pooled since)
+	if (!IsValid(pShip) || !pShip->IsShipActive() || !pOwningPlayer->TeamComponent->IsSameTeam(pShip->TeamComponent))
 	{
 		return false;
 	}
@@ -129,14 +157,50 @@ FString UDMCommand_MoveShip::CommandDebug_Implementation() const /* override */
 }
 
 /******************************************************************************
- * create a new moveship command object based on input data
+ * Clear our ship along with the base command data so the command can be pooled
 ******************************************************************************/
-UDMCommand* UDMCommand_MoveShip::CopyCommand(const FCommandPacket& Packet) /* override */
+void UDMCommand_MoveShip::ResetCommand() /* override */
 {
-	UDMCommand_MoveShip* pNewCommand = NewObject<UDMCommand_MoveShip>();
-	pNewCommand->GetCopyCommandData(Packet.Data);
+	Super::ResetCommand();
+
+	pShip = nullptr;
+	pOriginalNode = nullptr;
+}
 
-	return pNewCommand;
+/******************************************************************************
+ * Tell the target node our ship is coming and mark the ship as moving
+ * Neither depends on the order commands run in, so it can happen as soon as
+ *		the command is registered
+******************************************************************************/
+bool UDMCommand_MoveShip::PreStageCommand() /* override */
+{
+	if (!IsValid(pTargetNode) || !IsValid(pShip))
+	{
+		return false;
+	}
+
+	if (!pTargetNode->AddPendingShip(pShip, false, this))
+	{
+		return false;
+	}
+	pShip->CommandsComponent->AddCommandFlags(ECommandFlags::MovingShip);
+
+	return true;
+}
+
+/******************************************************************************
+ * Take our ship back out of the target's pending ships
+******************************************************************************/
+void UDMCommand_MoveShip::UndoPreStageCommand() /* override */
+{
+	if (IsValid(pTargetNode))
+	{
+		pTargetNode->RemovePendingShip(pShip);
+	}
+	if (IsValid(pShip))
+	{
+		pShip->CommandsComponent->RemoveCommandFlags(ECommandFlags::MovingShip);
+	}
 }
 
 /******************************************************************************
@@ -146,7 +210,9 @@ void UDMCommand_MoveShip::FillCopyCommandData(TArray<TObjectPtr<UObject>>& Comma
 {
 	Super::FillCopyCommandData(CommandData);
 
-	CommandData.Add(pShip);
+	// Send the node the ship is docked at instead of the ship; ships aren't replicated in lockstep,
+	// but every machine agrees on which ship is at which node
+	CommandData.Add(IsValid(pShip) ? pShip->GetCurrentNode() : nullptr);
 }
 
 void UDMCommand_MoveShip::GetCopyCommandData(const TArray<TObjectPtr<UObject>>& CommandData) /* override */
@@ -157,7 +223,8 @@ void UDMCommand_MoveShip::GetCopyCommandData(const TArray<TObjectPtr<UObject>>&
 		UE_LOG(LogCommands, Error, TEXT("UDMCommand_MoveShip::GetCopyCommandData: Data not properly instantiated, no data will be copied"))
 		return;
 	}
-	pShip = Cast<ADMShip>(CommandData[2]);
+	const ADMGalaxyNode* pShipNode = Cast<ADMGalaxyNode>(CommandData[2]);
+	pShip = IsValid(pShipNode) ? pShipNode->GetShip() : nullptr;
 
 	// Copy parent data + call validate
 	Super::GetCopyCommandData(CommandData);
@@ -4,10 +4,14 @@
 #include "Components/DMNodeConnectionComponent.h"
 
 #include "Components/SplineComponent.h"			// USplineComponent
+#include "GalaxyObjects/DMGalaxyGraphSubsystem.h"	// UDMGalaxyGraphSubsystem
 #include "GalaxyObjects/DMGalaxyNode.h"			// LogGalaxy, ADMGalaxyNode
 #include "Net/UnrealNetwork.h"					// DOREPLIFETIME
 #include "Player/DMShip.h"						// ADMShip
 #include "Components/DMCommandFlagsComponent.h"	// UDMActiveCommandsComponent, ECommandFlags
+#include "Components/DMTeamComponent.h"			// UDMTeamComponent
+#include "GameSettings/DMTurnEventLog.h"			// FDMTurnEventLog
+#include "GameSettings/DMTurnTrace.h"				// TRACE_COUNTER_INCREMENT
 
 /*/////////////////////////////////////////////////////////////////////////////
 *	UDMNodeConnectionComponent ////////////////////////////////////////////////
@@ -34,14 +38,13 @@ void UDMNodeConnectionComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProp
 }
 
 /******************************************************************************
- * On BeginPlay, Construct or find our connectors
+ * On BeginPlay, make sure we're on a node
+ * Connectors are spawned once per edge by UDMGalaxyGraphSubsystem
 ******************************************************************************/
 void UDMNodeConnectionComponent::BeginPlay() /* override */
 {
 	Super::BeginPlay();
 
-	ConnectorSplines.Init(nullptr, ConnectedNodes.Num());
-
 	AActor* pOwner = GetOwner();
 	ADMGalaxyNode* pNodeOwner = Cast<ADMGalaxyNode>(pOwner);
 	check(pNodeOwner);
@@ -51,43 +54,15 @@ void UDMNodeConnectionComponent::BeginPlay() /* override */
 		UE_LOG(LogGalaxy, Error, TEXT("UDMNodeConnectionComponent is on %s, which is not a GalaxyNode. UDMNodeConnectionComponent is not built for this class!"),
 			*pOwner->GetName())
 	}
-
-	// Either find or create a new connector for each connected node
-	for (size_t i = 0; i < ConnectedNodes.Num(); ++i)
-	{
-		UDMNodeConnectionComponent* pOtherConnector = ConnectedNodes[i]->GetConnectionManager();
-		check(pOtherConnector);
-
-		if (ADMConnector* pOtherNodesConnector = pOtherConnector->GetConnectorForNode(pNodeOwner))
-		{
-			ConnectorSplines[i] = pOtherNodesConnector;
-		}
-		else
-		{
-			if (ConnectorClass == nullptr)
-			{
-				UE_LOG(LogGalaxy, Error, TEXT("Class %s does not have a valid Connector Class set; no connectors will be made for this node!"),
-					*pOwner->GetClass()->GetName())
-
-				return;
-			}
-
-			UWorld* pWorld = GetWorld();
-			check(pWorld);
-			ADMConnector* pNewConnector = pWorld->SpawnActor<ADMConnector>(ConnectorClass);
-			pNewConnector->InitializeSplineMesh(pNodeOwner, ConnectedNodes[i]);
-			ConnectorSplines[i] = pNewConnector;
-		}
-
-	}
 }
 
 /******************************************************************************
- * Reserve a connector from this planet to another planet
- * If this function is called while another ship has reserved the conector,
- *		we will "bounce" that ship's movement
+ * Reserve the edge from this planet to another planet
+ * If this function is called while another ship has reserved the edge,
+ *		we will "bounce" that ship's movement. Only one ship sits at a node,
+ *		so the other ship can only be coming the opposite way: a swap.
  * 
- * Returns true if the spot is reserved; returns false if the connector is in
+ * Returns true if the spot is reserved; returns false if the edge is in
  *		use, or if the connection DNE
 ******************************************************************************/
 bool UDMNodeConnectionComponent::ReserveShipTraversal(ADMGalaxyNode* pTargetNode, ADMShip* pReservingShip)
@@ -107,8 +82,9 @@ bool UDMNodeConnectionComponent::ReserveShipTraversal(ADMGalaxyNode* pTargetNode
 		return false;
 	}
 
-	ADMConnector* pConnector = GetConnectorForNode(pTargetNode);
-	if (!IsValid(pConnector))
+	UDMGalaxyGraphSubsystem* pGraph = UDMGalaxyGraphSubsystem::Get(this);
+	const int32 EdgeId = IsValid(pGraph) ? pGraph->FindEdge(Cast<ADMGalaxyNode>(GetOwner()), pTargetNode) : INDEX_NONE;
+	if (EdgeId == INDEX_NONE)
 	{
 		UE_LOG(LogGalaxy, Error, TEXT("Ship %s tried to reserve a flight from node %s to %s, but that route is not valid!"),
 			*pReservingShip->GetName(),
@@ -118,14 +94,15 @@ bool UDMNodeConnectionComponent::ReserveShipTraversal(ADMGalaxyNode* pTargetNode
 			return false;
 	}
 
-	ADMShip* pTraversingShip = pConnector->GetTraversingShip();
+	ADMShip* pTraversingShip = pGraph->ReserveEdge(EdgeId, pReservingShip);
 	if (IsValid(pTraversingShip))
 	{
-		UE_LOG(LogGalaxy, Display, TEXT("Ships %s and %s both tried to traverse between nodes %s and %s; the ships have bounced"),
-			*pTraversingShip->GetName(),
-			*pReservingShip->GetName(),
-			*GetOwner()->GetName(),
-			*pTargetNode->GetName())
+		FDMTurnEventLog::Get(this).Record(EDMTurnEventType::ShipsBounced,
+			UDMTeamComponent::GetActorsTeam(pReservingShip),
+			pReservingShip,
+			pTargetNode,
+			pTraversingShip);
+		TRACE_COUNTER_INCREMENT(DMTurn_Bounces);
 
 		// Tell the original node the bounced ship isn't coming
 		ADMGalaxyNode* pOriginalNode = pReservingShip->GetCurrentNode();
@@ -136,27 +113,19 @@ bool UDMNodeConnectionComponent::ReserveShipTraversal(ADMGalaxyNode* pTargetNode
 		return false;
 	}
 
-	pConnector->SetTraversingShip(pReservingShip);
 	return true;
 }
 
 /******************************************************************************
- * Find the associated connector for the planet; should be at the same index
- * in the ConnectorSplines array as the planet is in our ConnectedNodes array
+ * Find the connector on the edge between our node and the given one
 ******************************************************************************/
 ADMConnector* UDMNodeConnectionComponent::GetConnectorForNode(const ADMGalaxyNode* Node)
 {
-	for (size_t i = 0; i < ConnectedNodes.Num(); ++i)
+	const UDMGalaxyGraphSubsystem* pGraph = UDMGalaxyGraphSubsystem::Get(this);
+	if (!IsValid(pGraph))
 	{
-		if (ConnectorSplines.Num() <= i)
-		{
-			return nullptr;
-		}
-		if (ConnectedNodes[i] == Node)
-		{
-			return ConnectorSplines[i];
-		}
+		return nullptr;
 	}
 
-	return nullptr;
+	return pGraph->GetEdgeConnector(pGraph->FindEdge(Cast<ADMGalaxyNode>(GetOwner()), Node));
 }
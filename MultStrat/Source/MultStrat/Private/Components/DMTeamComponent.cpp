@@ -3,6 +3,9 @@
 
 #include "Components/DMTeamComponent.h"
 
+#include "GalaxyObjects/DMBaseGalaxyObject.h"	// ADMBaseGalaxyObject
+#include "GameSettings/DMGameState.h"	// ADMGameState
+#include "GameSettings/DMTurnEventLog.h"	// FDMTurnEventLog
 #include "Net/UnrealNetwork.h"			// DOREPLIFETIME
 
 
@@ -32,6 +35,19 @@ void UDMTeamComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& Out
 	DOREPLIFETIME(UDMTeamComponent, PreviousTeam);
 }
 
+/******************************************************************************
+ * Galaxy objects' teams come out of turn resolution, which lockstep machines
+ *		do themselves; stop replicating them. Player teams still replicate.
+******************************************************************************/
+void UDMTeamComponent::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) /* override */
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	const bool bReplicateTeam = !(GetOwner() != nullptr && GetOwner()->IsA<ADMBaseGalaxyObject>() && ADMGameState::IsLockstep(this));
+	DOREPLIFETIME_ACTIVE_OVERRIDE(UDMTeamComponent, ActiveTeam, bReplicateTeam);
+	DOREPLIFETIME_ACTIVE_OVERRIDE(UDMTeamComponent, PreviousTeam, bReplicateTeam);
+}
+
 /*/////////////////////////////////////////////////////////////////////////////
 *	Team Testing //////////////////////////////////////////////////////////////
 *//////////////////////////////////////////////////////////////////////////////
@@ -104,11 +120,7 @@ EDMPlayerTeam UDMTeamComponent::GetActorsTeam(const AActor* TargetActor)
 EDMPlayerTeam UDMTeamComponent::SetTeam(EDMPlayerTeam NewTeam)
 {
 	// print debug
-	AActor* pOwner = GetOwner();
-	FString EnumName = StaticEnum<EDMPlayerTeam>()->GetAuthoredNameStringByIndex((int32)NewTeam);
-	UE_LOG(LogTeams, Display, TEXT("%s set to team %s"),
-		IsValid(pOwner) ? *pOwner->GetName() : TEXT("INVALID OWNER"),
-		*EnumName)
+	FDMTurnEventLog::Get(this).Record(EDMTurnEventType::TeamChanged, NewTeam, GetOwner());
 
 	// swap
 	PreviousTeam = ActiveTeam;
@@ -0,0 +1,302 @@
+// Copyright (c) 2025 William Pritz under MIT License
+
+
+#include "GalaxyObjects/DMGalaxyGraphSubsystem.h"
+
+#include "Algo/BinarySearch.h"						// Algo::BinarySearch
+#include "Algo/Sort.h"								// Algo::Sort
+#include "Algo/Unique.h"							// Algo::Unique
+#include "Components/DMNodeConnectionComponent.h"	// UDMNodeConnectionComponent, ADMConnector
+#include "EngineUtils.h"							// TActorIterator
+#include "GalaxyObjects/DMGalaxyNode.h"				// ADMGalaxyNode, LogGalaxy
+#include "Player/DMShip.h"							// ADMShip
+
+/******************************************************************************
+ * Static Gettor
+******************************************************************************/
+UDMGalaxyGraphSubsystem* UDMGalaxyGraphSubsystem::Get(UObject* WorldContextObject)
+{
+	UWorld* pWorld = WorldContextObject != nullptr ? WorldContextObject->GetWorld() : nullptr;
+	UDMGalaxyGraphSubsystem* pGraphSubsystem = pWorld != nullptr ? pWorld->GetSubsystem<UDMGalaxyGraphSubsystem>() : nullptr;
+
+	return pGraphSubsystem;
+}
+
+/******************************************************************************
+ * UWorldSubsystem Override
+ *
+ * Build the graph before any actor begins play; connections are set up in
+ *		the level, so they're already there
+******************************************************************************/
+void UDMGalaxyGraphSubsystem::OnWorldBeginPlay(UWorld& InWorld) /* override */
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	RebuildGraph();
+}
+
+/******************************************************************************
+ * Index every node in the world and rebuild the adjacency from their
+ *		connection components
+******************************************************************************/
+void UDMGalaxyGraphSubsystem::RebuildGraph()
+{
+	for (ADMGalaxyNode* pNode : Nodes)
+	{
+		if (IsValid(pNode))
+		{
+			pNode->GraphIndex = INDEX_NONE;
+		}
+	}
+	Nodes.Reset();
+
+	UWorld* pWorld = GetWorld();
+	check(pWorld);
+	for (TActorIterator<ADMGalaxyNode> It(pWorld); It; ++It)
+	{
+		if (IsValid(*It))
+		{
+			Nodes.Add(*It);
+		}
+	}
+
+	// Actor iteration order isn't the same on every machine; names are
+	Algo::Sort(Nodes, [](const ADMGalaxyNode* A, const ADMGalaxyNode* B)
+	{
+		return A->GetName() < B->GetName();
+	});
+	for (int32 i = 0; i < Nodes.Num(); ++i)
+	{
+		Nodes[i]->GraphIndex = i;
+	}
+
+	// Rows: each node's connections, sorted and without duplicates
+	NeighborOffsets.SetNumUninitialized(Nodes.Num() + 1);
+	Neighbors.Reset();
+	TArray<int64> EdgeKeys;
+	for (int32 i = 0; i < Nodes.Num(); ++i)
+	{
+		NeighborOffsets[i] = Neighbors.Num();
+
+		const UDMNodeConnectionComponent* pConnections = Nodes[i]->GetConnectionManager();
+		if (!IsValid(pConnections))
+		{
+			continue;
+		}
+
+		for (const ADMGalaxyNode* pConnected : pConnections->ConnectedNodes)
+		{
+			const int32 Neighbor = GetNodeIndex(pConnected);
+			if (Neighbor == INDEX_NONE || Neighbor == i)
+			{
+				UE_LOG(LogGalaxy, Warning, TEXT("UDMGalaxyGraphSubsystem::RebuildGraph: %s has an invalid connection to %s; ignoring it"),
+					*Nodes[i]->GetName(),
+					*GetNameSafe(pConnected))
+				continue;
+			}
+			Neighbors.Add(Neighbor);
+
+			// Both directions share one edge
+			EdgeKeys.Add(((int64)FMath::Min(i, Neighbor) << 32) | FMath::Max(i, Neighbor));
+		}
+
+		TArrayView<int32> Row(Neighbors.GetData() + NeighborOffsets[i], Neighbors.Num() - NeighborOffsets[i]);
+		Row.Sort();
+		const int32 NumUnique = Algo::Unique(Row);
+		Neighbors.SetNum(NeighborOffsets[i] + NumUnique, EAllowShrinking::No);
+	}
+	NeighborOffsets[Nodes.Num()] = Neighbors.Num();
+
+	// Edge ids in (start, end) order, so they match on every machine too
+	EdgeKeys.Sort();
+	EdgeKeys.SetNum(Algo::Unique(EdgeKeys));
+	EdgeStart.SetNumUninitialized(EdgeKeys.Num());
+	EdgeEnd.SetNumUninitialized(EdgeKeys.Num());
+	for (int32 Edge = 0; Edge < EdgeKeys.Num(); ++Edge)
+	{
+		EdgeStart[Edge] = (int32)(EdgeKeys[Edge] >> 32);
+		EdgeEnd[Edge] = (int32)(EdgeKeys[Edge] & MAX_uint32);
+	}
+
+	NeighborEdges.SetNumUninitialized(Neighbors.Num());
+	for (int32 i = 0; i < Nodes.Num(); ++i)
+	{
+		for (int32 Slot = NeighborOffsets[i]; Slot < NeighborOffsets[i + 1]; ++Slot)
+		{
+			const int32 Neighbor = Neighbors[Slot];
+			const int64 Key = ((int64)FMath::Min(i, Neighbor) << 32) | FMath::Max(i, Neighbor);
+			NeighborEdges[Slot] = Algo::BinarySearch(EdgeKeys, Key);
+		}
+	}
+
+	SpawnConnectors();
+
+	// Edge ids changed; nothing reserved under the old ones carries over
+	EdgeReservations.Init(nullptr, EdgeStart.Num());
+	EdgeReservationTurns.Init(0, EdgeStart.Num());
+
+	++Generation;
+}
+
+/******************************************************************************
+ * Spawn one connector per edge, destroying any left from a previous build
+ * One pass over the edges; no node has to ask its neighbors whether they've
+ *		already made the connector, so begin play order doesn't matter
+******************************************************************************/
+void UDMGalaxyGraphSubsystem::SpawnConnectors()
+{
+	for (ADMConnector* pConnector : EdgeConnectors)
+	{
+		if (IsValid(pConnector))
+		{
+			pConnector->Destroy();
+		}
+	}
+	EdgeConnectors.Init(nullptr, EdgeStart.Num());
+
+	UWorld* pWorld = GetWorld();
+	check(pWorld);
+	for (int32 Edge = 0; Edge < EdgeStart.Num(); ++Edge)
+	{
+		ADMGalaxyNode* pStart = Nodes[EdgeStart[Edge]];
+		ADMGalaxyNode* pEnd = Nodes[EdgeEnd[Edge]];
+
+		// Either end's connector class will do
+		TSubclassOf<ADMConnector> ConnectorClass = pStart->GetConnectionManager()->GetConnectorClass();
+		if (ConnectorClass == nullptr)
+		{
+			ConnectorClass = pEnd->GetConnectionManager()->GetConnectorClass();
+		}
+		if (ConnectorClass == nullptr)
+		{
+			UE_LOG(LogGalaxy, Error, TEXT("Neither %s nor %s has a valid Connector Class set; no connector will be made between them!"),
+				*pStart->GetName(),
+				*pEnd->GetName())
+			continue;
+		}
+
+		ADMConnector* pNewConnector = pWorld->SpawnActor<ADMConnector>(ConnectorClass);
+		pNewConnector->InitializeSplineMesh(pStart, pEnd);
+		EdgeConnectors[Edge] = pNewConnector;
+	}
+}
+
+/*/////////////////////////////////////////////////////////////////////////////
+*	Queries ///////////////////////////////////////////////////////////////////
+*//////////////////////////////////////////////////////////////////////////////
+
+/******************************************************************************
+ * Graph index of the node, INDEX_NONE if it isn't part of the graph
+******************************************************************************/
+int32 UDMGalaxyGraphSubsystem::GetNodeIndex(const ADMGalaxyNode* pNode) const
+{
+	if (pNode == nullptr)
+	{
+		return INDEX_NONE;
+	}
+
+	// Nodes from another world, or spawned since the last rebuild, don't count
+	const int32 Index = pNode->GraphIndex;
+	return Nodes.IsValidIndex(Index) && Nodes[Index] == pNode ? Index : INDEX_NONE;
+}
+
+/******************************************************************************
+ * Sorted graph indices of every node NodeIndex connects to
+******************************************************************************/
+TConstArrayView<int32> UDMGalaxyGraphSubsystem::GetNeighbors(int32 NodeIndex) const
+{
+	if (!Nodes.IsValidIndex(NodeIndex))
+	{
+		return TConstArrayView<int32>();
+	}
+
+	return TConstArrayView<int32>(Neighbors.GetData() + NeighborOffsets[NodeIndex], NeighborOffsets[NodeIndex + 1] - NeighborOffsets[NodeIndex]);
+}
+
+/******************************************************************************
+ * Edge ids matching GetNeighbors, entry for entry
+******************************************************************************/
+TConstArrayView<int32> UDMGalaxyGraphSubsystem::GetNeighborEdges(int32 NodeIndex) const
+{
+	if (!Nodes.IsValidIndex(NodeIndex))
+	{
+		return TConstArrayView<int32>();
+	}
+
+	return TConstArrayView<int32>(NeighborEdges.GetData() + NeighborOffsets[NodeIndex], NeighborOffsets[NodeIndex + 1] - NeighborOffsets[NodeIndex]);
+}
+
+/******************************************************************************
+ * True if From lists To as a connection
+******************************************************************************/
+bool UDMGalaxyGraphSubsystem::AreAdjacent(const ADMGalaxyNode* pFrom, const ADMGalaxyNode* pTo) const
+{
+	return AreAdjacent(GetNodeIndex(pFrom), GetNodeIndex(pTo));
+}
+
+/******************************************************************************
+ * Id of the edge From uses to reach To; INDEX_NONE if From doesn't connect
+ *		to To
+******************************************************************************/
+int32 UDMGalaxyGraphSubsystem::FindEdge(int32 From, int32 To) const
+{
+	const int32 Index = FindNeighborIndex(From, To);
+	return Index != INDEX_NONE ? NeighborEdges[NeighborOffsets[From] + Index] : INDEX_NONE;
+}
+
+int32 UDMGalaxyGraphSubsystem::FindEdge(const ADMGalaxyNode* pFrom, const ADMGalaxyNode* pTo) const
+{
+	return FindEdge(GetNodeIndex(pFrom), GetNodeIndex(pTo));
+}
+
+/******************************************************************************
+ * Position of To in GetNeighbors(From); INDEX_NONE if From doesn't connect
+ *		to To
+ * Neighbors are sorted, so this is a binary search: O(log degree)
+******************************************************************************/
+int32 UDMGalaxyGraphSubsystem::FindNeighborIndex(int32 From, int32 To) const
+{
+	if (!Nodes.IsValidIndex(From) || To == INDEX_NONE)
+	{
+		return INDEX_NONE;
+	}
+
+	return Algo::BinarySearch(GetNeighbors(From), To);
+}
+
+/*/////////////////////////////////////////////////////////////////////////////
+*	Edge Reservations /////////////////////////////////////////////////////////
+*//////////////////////////////////////////////////////////////////////////////
+
+/******************************************************************************
+ * Claim an edge for a ship moving along it this turn
+ * returns the ship that already holds the edge, or nullptr if the edge was
+ *		free and now belongs to Ship
+ * Both directions share an edge, so two ships swapping nodes collide here
+******************************************************************************/
+ADMShip* UDMGalaxyGraphSubsystem::ReserveEdge(int32 EdgeId, ADMShip* pShip)
+{
+	check(EdgeReservations.IsValidIndex(EdgeId));
+
+	if (EdgeReservationTurns[EdgeId] == ReservationTurn && EdgeReservations[EdgeId] != pShip)
+	{
+		return EdgeReservations[EdgeId];
+	}
+
+	EdgeReservations[EdgeId] = pShip;
+	EdgeReservationTurns[EdgeId] = ReservationTurn;
+	return nullptr;
+}
+
+/******************************************************************************
+ * Ship holding the edge this turn, nullptr if it's free
+******************************************************************************/
+ADMShip* UDMGalaxyGraphSubsystem::GetEdgeReservation(int32 EdgeId) const
+{
+	if (!EdgeReservations.IsValidIndex(EdgeId) || EdgeReservationTurns[EdgeId] != ReservationTurn)
+	{
+		return nullptr;
+	}
+
+	return EdgeReservations[EdgeId];
+}
@@ -4,10 +4,14 @@
 #include "GalaxyObjects/DMGalaxyNode.h"
 
 #include "Commands/DMCommand.h"						// UDMCommand
-#include "Components/DMCommandFlagsComponent.h"		// UDMActiveCommandsComponent
 #include "Components/DMNodeConnectionComponent.h"	// UDMNodeConnectionComponent
 #include "Components/DMTeamComponent.h"				// EDMPlayerTeam
+#include "GalaxyObjects/DMGalaxyGraphSubsystem.h"		// UDMGalaxyGraphSubsystem
+#include "GalaxyObjects/DMPlanetProcessingSubsystem.h"	// UDMPlanetProcessingSubsystem
 #include "GameSettings/DMGameMode.h"				// ADMGameMode
+#include "GameSettings/DMGameState.h"				// ADMGameState
+#include "GameSettings/DMTurnEventLog.h"			// FDMTurnEventLog
+#include "GameSettings/DMTurnTrace.h"				// DM_TURN_TRACE_SCOPE
 #include "Net/UnrealNetwork.h"						// DOREPLIFETIME
 #include "Player/DMShip.h"							// ADMShip
 
@@ -32,151 +36,107 @@ void ADMGalaxyNode::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLif
 	DOREPLIFETIME(ADMGalaxyNode, CurrentShip);
 }
 
-/*/////////////////////////////////////////////////////////////////////////////
-*	Command Functions /////////////////////////////////////////////////////////
-*//////////////////////////////////////////////////////////////////////////////
-
 /******************************************************************************
- * Check all pending ships and see if the math works out where no matter what happens
- * in other combats, this node can safely resolve
+ * Lockstep machines resolve ships themselves; stop replicating them
 ******************************************************************************/
-bool ADMGalaxyNode::CanResolveTurn()
+void ADMGalaxyNode::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) /* override */
 {
-	// 1; No pending ships = resolvable
-	if (PendingShips.IsEmpty())
-	{
-		return true;
-	}
-
-	// 2: Current ship on node is Not Moving or DNE  = resolvable
-	ADMShip* CurrShip = GetShip();
-	if (CurrShip == nullptr || !CurrShip->CommandsComponent->CheckForCommandFlags(ECommandFlags::MovingShip))
-	{
-		return true;
-	}
-
-	// 3; current ship Does not matter for result (win or tie for home team without it)  = resolvable
-	// Map of all teams trying to take control of the planet; mapping their team to the main attacking ship and the total power of their fleet
-	TMap<EDMPlayerTeam, TPair<ADMShip*, size_t>> Powers;
-	GetPendingPowers(Powers);
-
-	// Find the winner
-	size_t HighestPower = 0;
-	size_t PowerDiff = 0;
-	EDMPlayerTeam WinningTeam = EDMPlayerTeam::Invalid;
-	for (auto TeamPower : Powers)
-	{
-		EDMPlayerTeam eTeam = TeamPower.Key;
-		ADMShip* pShipPtr = TeamPower.Value.Key;
-		size_t Power = TeamPower.Value.Value;
+	Super::PreReplication(ChangedPropertyTracker);
 
-		if (pShipPtr == nullptr)
-		{
-			continue;
-		}
+	DOREPLIFETIME_ACTIVE_OVERRIDE(ADMGalaxyNode, CurrentShip, !ADMGameState::IsLockstep(this));
+}
 
-		if (Power > HighestPower)
-		{
-			PowerDiff = Power - HighestPower;
-			HighestPower = Power;
-			WinningTeam = eTeam;
-		}
-		else if (Power == HighestPower)
-		{
-			// No winner in the case of a tie
-			WinningTeam = EDMPlayerTeam::Invalid;
-			PowerDiff = 0;
-		}
-	}
-	if (WinningTeam == TeamComponent->GetTeam() &&
-		PowerDiff >= CurrShip->GetShipPower())
-	{
-		return true;
-	}
+/******************************************************************************
+ * Start contributing to the galaxy hash
+******************************************************************************/
+void ADMGalaxyNode::BeginPlay() /* override */
+{
+	Super::BeginPlay();
 
-	// Not Resolvable
-	return false;
+	NameHash = FCrc::StrCrc32(*GetName());
+	TeamComponent->OnActiveTeamChanged.AddDynamic(this, &ADMGalaxyNode::OnTeamChanged);
+	UpdateStateHash();
 }
 
 /******************************************************************************
- * Resolve all pending ships after all the commands have executed for a turn
+ * Stop contributing to the galaxy hash
 ******************************************************************************/
-void ADMGalaxyNode::ResolveTurn()
+void ADMGalaxyNode::EndPlay(const EEndPlayReason::Type EndPlayReason) /* override */
 {
-	// No work to be done
-	if (PendingShips.IsEmpty())
+	if (UDMPlanetProcessingSubsystem* pPlanetProcessing = UDMPlanetProcessingSubsystem::Get(this))
 	{
-		return;
+		pPlanetProcessing->UpdateGalaxyHash(StateHash, 0);
 	}
+	StateHash = 0;
 
-	// Map of all teams trying to take control of the planet; mapping their team to the main attacking ship and the total power of their fleet
-	TMap<EDMPlayerTeam, TPair<ADMShip*, size_t>> Powers;
-	GetPendingPowers(Powers);
+	Super::EndPlay(EndPlayReason);
+}
 
+/*/////////////////////////////////////////////////////////////////////////////
+*	Command Functions /////////////////////////////////////////////////////////
+*//////////////////////////////////////////////////////////////////////////////
 
-	FString NodeTeam = StaticEnum<EDMPlayerTeam>()->GetAuthoredNameStringByIndex((int32)TeamComponent->GetTeam());
-	UE_LOG(LogGalaxy, Display, TEXT("%s combat results (Previous Owner: %s): "),
-		*GetName(),
-		*NodeTeam)
+/******************************************************************************
+ * Apply this turn's combat result, worked out by FDMGalaxyState: the loser is
+ *		pooled (destroyed on lockstep clients, which have no pool) and the
+ *		winner takes the node
+ * Ships lost elsewhere this turn are already marked dead in the state, and
+ *		every node's pending ships are reset here, so a pooled ship is never
+ *		counted again
+******************************************************************************/
+void ADMGalaxyNode::ApplyTurnResult(const FDMTeamPowers& Powers, EDMPlayerTeam WinningTeam)
+{
+	DM_TURN_TRACE_SCOPE(ResolveTurn);
+	TRACE_COUNTER_INCREMENT(DMTurn_Combats);
 
-	// Find the winner
-	size_t HighestPower = 0;
-	ADMShip* WinningShip = nullptr;
-	for (auto TeamPower : Powers)
+	FDMTurnEventLog& EventLog = FDMTurnEventLog::Get(this);
+	EventLog.Record(EDMTurnEventType::CombatStarted, TeamComponent->GetTeam(), this);
+	for (int32 Team = 0; Team < FDMTeamPowers::NumTeams; ++Team)
 	{
-		EDMPlayerTeam eTeam = TeamPower.Key;
-		ADMShip* pShipPtr = TeamPower.Value.Key;
-		size_t Power = TeamPower.Value.Value;
-
-		FString EnumName = StaticEnum<EDMPlayerTeam>()->GetAuthoredNameStringByIndex((int32)eTeam);
-		FString AttackDebug = FString::Printf(TEXT("	Attacked by team %s with power %d"),
-			*EnumName,
-			Power);
-
-		if (pShipPtr == nullptr)
+		if (Powers.IsInvolved((EDMPlayerTeam)Team))
 		{
-			AttackDebug.Append(", But they forgot to send an attacking ship!");
-			UE_LOG(LogGalaxy, Display, TEXT("%s"), *AttackDebug)
-			continue;
-		}
-
-		UE_LOG(LogGalaxy, Display, TEXT("%s"), *AttackDebug)
-
-		if (Power > HighestPower)
-		{
-			HighestPower = Power;
-			WinningShip = pShipPtr;
-		}
-		else if (Power == HighestPower)
-		{
-			// No winner in the case of a tie
-			WinningShip = nullptr;
+			EventLog.Record(Powers.Ships[Team] != nullptr ? EDMTurnEventType::CombatAttacker : EDMTurnEventType::CombatSupportOnly,
+				(EDMPlayerTeam)Team, this, nullptr, nullptr, (int32)Powers.Powers[Team]);
 		}
 	}
 
+	// Find the winner
+	ADMShip* WinningShip = WinningTeam != EDMPlayerTeam::Invalid ? Powers.Ships[(int32)WinningTeam] : nullptr;
+
 	// Declare the winner!
 	if (WinningShip != nullptr)
 	{
 		// debug
-		FString WinnerEnumName = StaticEnum<EDMPlayerTeam>()->GetAuthoredNameStringByIndex((int32)WinningShip->TeamComponent->GetTeam());
-		UE_LOG(LogGalaxy, Display, TEXT("	The winner is %s!"),
-			*WinnerEnumName);
+		EventLog.Record(EDMTurnEventType::CombatWinner, WinningShip->TeamComponent->GetTeam(), this, WinningShip);
 
 		if (IsValid(CurrentShip) && CurrentShip != WinningShip)
 		{
 			// DMTODO: Ship Retreats
-			CurrentShip->Destroy();
+			// Pool the loser for a future build; lockstep clients have no game mode, so no pool
+			UWorld* pWorld = GetWorld();
+			ADMGameMode* pGameMode = IsValid(pWorld) ? pWorld->GetAuthGameMode<ADMGameMode>() : nullptr;
+			if (IsValid(pGameMode))
+			{
+				pGameMode->ReleaseShip(CurrentShip);
+			}
+			else
+			{
+				CurrentShip->Destroy();
+			}
 		}
 
 		SetCurrentShip(WinningShip);
 	}
 	else
 	{
-		UE_LOG(LogGalaxy, Display, TEXT("There is no winner!"));
+		EventLog.Record(EDMTurnEventType::CombatNoWinner, TeamComponent->GetTeam(), this);
 	}
 
-	// Cleanup
-	PendingShips.Empty();
+	// Cleanup; keep the allocation, this node will likely see ships again
+	PendingShips.Reset();
+
+	// The old ship may have been destroyed without a new one taking its place
+	UpdateStateHash();
 }
 
 /******************************************************************************
@@ -199,6 +159,7 @@ void ADMGalaxyNode::RemoveShip(const UDMCommand* OwningCommand)
 	}
 
 	CurrentShip = nullptr;
+	UpdateStateHash();
 }
 
 /******************************************************************************
@@ -216,6 +177,11 @@ bool ADMGalaxyNode::AddPendingShip(ADMShip* NewShip, bool Supporting, const UDMC
 	}
 
 	PendingShips.Add(NewShip, Supporting);
+	if (UDMPlanetProcessingSubsystem* pPlanetProcessing = UDMPlanetProcessingSubsystem::Get(this))
+	{
+		pPlanetProcessing->MarkNodeDirty(this);
+	}
+
 	return true;
 }
 
@@ -225,7 +191,12 @@ bool ADMGalaxyNode::AddPendingShip(ADMShip* NewShip, bool Supporting, const UDMC
 ******************************************************************************/
 bool ADMGalaxyNode::RemovePendingShip(ADMShip* NewShip)
 {
-	return PendingShips.Remove(NewShip) != 0;
+	if (PendingShips.Remove(NewShip) == 0)
+	{
+		return false;
+	}
+
+	return true;
 }
 
 /******************************************************************************
@@ -257,7 +228,7 @@ bool ADMGalaxyNode::ReserveTraversalTo(ADMGalaxyNode* TargetNode, ADMShip* Reser
 ******************************************************************************/
 void ADMGalaxyNode::SetCurrentShip(ADMShip* NewShip)
 {
-	if (!HasAuthority())
+	if (!HasAuthority() && !ADMGameState::IsLockstep(this))
 	{
 		UE_LOG(LogGalaxy, Error, TEXT("ADMGalaxyNode::SetCurrentShip: %s tried to set its current ship to %s, but not on the main server?"),
 			*GetName(),
@@ -274,20 +245,28 @@ void ADMGalaxyNode::SetCurrentShip(ADMShip* NewShip)
 		return;
 	}
 
+	// Pooled ships are still valid; one lost in combat elsewhere this turn can't take the node
+	if (!NewShip->IsShipActive())
+	{
+		UE_LOG(LogGalaxy, Warning, TEXT("ADMGalaxyNode::SetCurrentShip: %s tried to set its current ship to %s, which is pooled"),
+			*GetName(),
+			*NewShip->GetName())
+		return;
+	}
+
 	// remove it from its current node
 	if (ADMGalaxyNode* pParent = Cast<ADMGalaxyNode>(NewShip->GetCurrentNode()))
 	{
 		pParent->RemoveShip();
 	}
 
-	// Get the gamemode
-	UWorld* pWorld = GetWorld();
-	AGameModeBase* pGameModeBase = IsValid(pWorld) ? pWorld->GetAuthGameMode() : nullptr;
-	ADMGameMode* pGameMode = Cast<ADMGameMode>(pGameModeBase);
+	// Get the gamestate; lockstep clients place ships too, and they don't have a gamemode
+	ADMGameState* pGameState = ADMGameState::Get(this);
+	check(pGameState)
 	
 	// set the ships position
 	FVector ShipPosition = GetActorLocation();
-	ShipPosition.Z += pGameMode->GetShipSpawnZOffset();
+	ShipPosition.Z += pGameState->GetShipSpawnZOffset();
 	NewShip->SetActorLocation(ShipPosition);
 	if (!NewShip->AttachToActor(this, FAttachmentTransformRules::KeepWorldTransform))
 	{
@@ -299,66 +278,68 @@ void ADMGalaxyNode::SetCurrentShip(ADMShip* NewShip)
 
 	// (TF2 Heavy voice) OURS NOW
 	CurrentShip = NewShip;
+	UpdateStateHash();
+	if (UDMPlanetProcessingSubsystem* pPlanetProcessing = UDMPlanetProcessingSubsystem::Get(this))
+	{
+		pPlanetProcessing->MarkNodeDirty(this);
+	}
 
 }
 
 /******************************************************************************
- * Calculate the power of all factions attack this node
+ * Owner, ship team or ship power may have changed; swap this node's old state
+ *		hash in the galaxy hash for the new one
+ * Only things every machine agrees on go in: the node's name, its team, and
+ *		its ship's team and power (never the ship's name; spawned actors are
+ *		named differently on each machine).
 ******************************************************************************/
-void ADMGalaxyNode::GetPendingPowers(TMap<EDMPlayerTeam, TPair<ADMShip*, size_t>>& Powers)
+void ADMGalaxyNode::UpdateStateHash()
 {
-	// Account for the current ship on the planet (if there is one)
-	if (IsValid(CurrentShip))
+	// Nodes join the hash in BeginPlay
+	if (!HasActorBegunPlay() && !IsActorBeginningPlay())
 	{
-		Powers.Add(CurrentShip->TeamComponent->GetTeam(), TPair<ADMShip*, size_t>(CurrentShip, 1));
+		return;
 	}
 
-	// Process all pending ships
-	for (auto AttemptedShip : PendingShips)
+	const bool bHasShip = IsValid(CurrentShip);
+	const uint32 State[] =
 	{
-		ADMShip* pShipPtr = AttemptedShip.Key;
-		bool Supporting = AttemptedShip.Value;
+		(uint32)TeamComponent->GetTeam(),
+		bHasShip ? (uint32)CurrentShip->TeamComponent->GetTeam() : MAX_uint32,
+		bHasShip ? (uint32)CurrentShip->GetShipPower() : 0u,
+	};
+	const uint32 NewStateHash = FCrc::MemCrc32(State, sizeof(State), NameHash);
 
-		TPair<ADMShip*, size_t>* CurrentAttacking = Powers.Find(pShipPtr->TeamComponent->GetTeam());
+	if (NewStateHash == StateHash)
+	{
+		return;
+	}
 
-		// Attacker: No previous attacker -> Add the team to the map
-		// Supporter: No previous attacker -> Add the team to the map
-		// Attacker: Yes previous attacker -> Ignore
-		// Supporter: Yes previous attacker -> increment power
-		if (CurrentAttacking == nullptr)
-		{
-			// this could be one line but it would be really annoying to read
-			if (Supporting)
-			{
-				Powers.Add(pShipPtr->TeamComponent->GetTeam(), TPair<ADMShip*, size_t>(nullptr, pShipPtr->GetShipPower()));
-			}
-			else
-			{
-				Powers.Add(pShipPtr->TeamComponent->GetTeam(), TPair<ADMShip*, size_t>(pShipPtr, pShipPtr->GetShipPower()));
-			}
-		}
-		else
-		{
-			if (Supporting)
-			{
-				++CurrentAttacking->Value;
-			}
-			else if (CurrentAttacking->Key != nullptr)
-			{
-				CurrentAttacking->Key = pShipPtr;
-				++CurrentAttacking->Value;
-			}
-			// Just ignore the ship if there are multiple attackers
-			// TMDOTO: Imagine a situation:
-			// Planet A (Team1) has a ship of power 1
-			// Planet B (Team1) has a ship of power 1
-			// Planet C (Team2)has a ship of power 2
-			// 
-			// C Is attacking A
-			// A's ship wants to move to some planet D, but doesn't know if it will bounce
-			// if A bounces and B Supports A, A defends successfully
-			// if A bounces and B Moves to A, A fails defense (B cannot move to A, power not counted)
-			// Note; it's not like team 1 will KNOW C is attacking A, so they wont know; move or support?
-		}
+	if (UDMPlanetProcessingSubsystem* pPlanetProcessing = UDMPlanetProcessingSubsystem::Get(this))
+	{
+		pPlanetProcessing->UpdateGalaxyHash(StateHash, NewStateHash);
+	}
+	StateHash = NewStateHash;
+
+	// The same things decide which nodes block multi hop routes
+	if (UDMGalaxyGraphSubsystem* pGraph = UDMGalaxyGraphSubsystem::Get(this))
+	{
+		pGraph->MarkBlockingStateChanged();
 	}
 }
+
+/******************************************************************************
+ * Keep the galaxy hash in step with team changes, including replicated ones
+******************************************************************************/
+void ADMGalaxyNode::OnTeamChanged(AActor* ChangedActor, EDMPlayerTeam NewTeam)
+{
+	UpdateStateHash();
+}
+
+/******************************************************************************
+ * Keep the galaxy hash in step with the replicated ship
+******************************************************************************/
+void ADMGalaxyNode::OnRep_CurrentShip()
+{
+	UpdateStateHash();
+}
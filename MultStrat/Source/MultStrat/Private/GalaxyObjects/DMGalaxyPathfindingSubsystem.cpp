@@ -0,0 +1,446 @@
+// Copyright (c) 2025 William Pritz under MIT License
+
+
+#include "GalaxyObjects/DMGalaxyPathfindingSubsystem.h"
+
+#include "Algo/Reverse.h"							// Algo::Reverse
+#include "Async/ParallelFor.h"						// ParallelFor
+#include "Components/DMTeamComponent.h"				// UDMTeamComponent, EDMPlayerTeam
+#include "GalaxyObjects/DMGalaxyGraphSubsystem.h"	// UDMGalaxyGraphSubsystem
+#include "GalaxyObjects/DMGalaxyNode.h"				// ADMGalaxyNode
+#include "GameSettings/DMTurnTrace.h"				// DM_TURN_TRACE_SCOPE
+#include "Player/DMShip.h"							// ADMShip
+
+/******************************************************************************
+ * Static Gettor
+******************************************************************************/
+UDMGalaxyPathfindingSubsystem* UDMGalaxyPathfindingSubsystem::Get(UObject* WorldContextObject)
+{
+	UWorld* pWorld = WorldContextObject != nullptr ? WorldContextObject->GetWorld() : nullptr;
+	UDMGalaxyPathfindingSubsystem* pPathfinding = pWorld != nullptr ? pWorld->GetSubsystem<UDMGalaxyPathfindingSubsystem>() : nullptr;
+
+	return pPathfinding;
+}
+
+/*/////////////////////////////////////////////////////////////////////////////
+*	Queries ///////////////////////////////////////////////////////////////////
+*//////////////////////////////////////////////////////////////////////////////
+
+/******************************************************************************
+ * Fewest moves it takes to get from one node to another; 0 for the same node
+ * returns INDEX_NONE if To can't be reached from From
+******************************************************************************/
+int32 UDMGalaxyPathfindingSubsystem::GetDistance(const ADMGalaxyNode* pFrom, const ADMGalaxyNode* pTo)
+{
+	const UDMGalaxyGraphSubsystem* pGraph = UpdateCache();
+	const int32 From = IsValid(pGraph) ? pGraph->GetNodeIndex(pFrom) : INDEX_NONE;
+	const int32 To = IsValid(pGraph) ? pGraph->GetNodeIndex(pTo) : INDEX_NONE;
+	if (From == INDEX_NONE || To == INDEX_NONE)
+	{
+		return INDEX_NONE;
+	}
+
+	if (BuildAllPairsTable(*pGraph))
+	{
+		return GetTableDistance(From, To);
+	}
+
+	// A* stops as soon as it reaches the goal; a full BFS would visit the whole galaxy
+	TArray<int32> Path;
+	return AStar(*pGraph, From, To, Path) ? Path.Num() - 1 : INDEX_NONE;
+}
+
+/******************************************************************************
+ * Shortest route from one node to another, both ends included
+ * returns false (and an empty route) if To can't be reached from From
+******************************************************************************/
+bool UDMGalaxyPathfindingSubsystem::FindPath(const ADMGalaxyNode* pFrom, const ADMGalaxyNode* pTo, TArray<ADMGalaxyNode*>& OutPath)
+{
+	OutPath.Reset();
+
+	const UDMGalaxyGraphSubsystem* pGraph = UpdateCache();
+	const int32 From = IsValid(pGraph) ? pGraph->GetNodeIndex(pFrom) : INDEX_NONE;
+	const int32 To = IsValid(pGraph) ? pGraph->GetNodeIndex(pTo) : INDEX_NONE;
+	if (From == INDEX_NONE || To == INDEX_NONE)
+	{
+		return false;
+	}
+
+	TArray<int32> Path;
+	if (BuildAllPairsTable(*pGraph))
+	{
+		// Walk downhill: some neighbor is always one move closer to the goal
+		int32 Remaining = GetTableDistance(From, To);
+		if (Remaining == INDEX_NONE)
+		{
+			return false;
+		}
+
+		Path.Reserve(Remaining + 1);
+		Path.Add(From);
+		for (int32 Current = From; Remaining > 0; --Remaining)
+		{
+			for (const int32 Neighbor : pGraph->GetNeighbors(Current))
+			{
+				if (GetTableDistance(Neighbor, To) == Remaining - 1)
+				{
+					Current = Neighbor;
+					break;
+				}
+			}
+			Path.Add(Current);
+		}
+	}
+	else if (!AStar(*pGraph, From, To, Path))
+	{
+		return false;
+	}
+
+	OutPath.Reserve(Path.Num());
+	for (const int32 Node : Path)
+	{
+		OutPath.Add(pGraph->GetNode(Node));
+	}
+	return true;
+}
+
+/******************************************************************************
+ * GetDistance for many questions at once; OutDistances[i] answers Queries[i]
+ * Questions are grouped by start node and each start node gets one BFS, run
+ *		on worker threads
+******************************************************************************/
+void UDMGalaxyPathfindingSubsystem::GetDistances(TConstArrayView<FDMPathQuery> Queries, TArray<int32>& OutDistances)
+{
+	DM_TURN_TRACE_SCOPE(PathfindingBatch);
+
+	OutDistances.Init(INDEX_NONE, Queries.Num());
+
+	const UDMGalaxyGraphSubsystem* pGraph = UpdateCache();
+	if (!IsValid(pGraph))
+	{
+		return;
+	}
+
+	if (BuildAllPairsTable(*pGraph))
+	{
+		for (int32 i = 0; i < Queries.Num(); ++i)
+		{
+			const int32 From = pGraph->GetNodeIndex(Queries[i].From);
+			const int32 To = pGraph->GetNodeIndex(Queries[i].To);
+			if (From != INDEX_NONE && To != INDEX_NONE)
+			{
+				OutDistances[i] = GetTableDistance(From, To);
+			}
+		}
+		return;
+	}
+
+	// Group the questions by start node
+	TArray<int32> Starts;
+	TMap<int32, TArray<int32>> QueriesByStart;
+	for (int32 i = 0; i < Queries.Num(); ++i)
+	{
+		const int32 From = pGraph->GetNodeIndex(Queries[i].From);
+		if (From == INDEX_NONE)
+		{
+			continue;
+		}
+
+		TArray<int32>* pStartQueries = QueriesByStart.Find(From);
+		if (pStartQueries == nullptr)
+		{
+			Starts.Add(From);
+			pStartQueries = &QueriesByStart.Add(From);
+		}
+		pStartQueries->Add(i);
+	}
+
+	// Each task answers only its own start node's questions, so no locking is needed
+	ParallelFor(TEXT("DMPathfindingBatch"), Starts.Num(), BatchSize, [pGraph, Queries, &Starts, &QueriesByStart, &OutDistances](int32 Index)
+	{
+		const int32 From = Starts[Index];
+		TArray<int32> Distances;
+		BreadthFirst(*pGraph, From, Distances);
+
+		for (const int32 Query : QueriesByStart.FindChecked(From))
+		{
+			const int32 To = pGraph->GetNodeIndex(Queries[Query].To);
+			OutDistances[Query] = To != INDEX_NONE ? Distances[To] : INDEX_NONE;
+		}
+	});
+}
+
+/******************************************************************************
+ * Distance from one node to every node in the graph, by graph index;
+ *		INDEX_NONE where unreachable
+******************************************************************************/
+void UDMGalaxyPathfindingSubsystem::GetDistancesFrom(const ADMGalaxyNode* pFrom, TArray<int32>& OutDistances)
+{
+	const UDMGalaxyGraphSubsystem* pGraph = UpdateCache();
+	const int32 From = IsValid(pGraph) ? pGraph->GetNodeIndex(pFrom) : INDEX_NONE;
+	if (From == INDEX_NONE)
+	{
+		OutDistances.Reset();
+		return;
+	}
+
+	if (BuildAllPairsTable(*pGraph))
+	{
+		OutDistances.SetNumUninitialized(pGraph->GetNumNodes());
+		for (int32 To = 0; To < OutDistances.Num(); ++To)
+		{
+			OutDistances[To] = GetTableDistance(From, To);
+		}
+		return;
+	}
+
+	BreadthFirst(*pGraph, From, OutDistances);
+}
+
+/******************************************************************************
+ * Every node a ship of the given team could reach within MaxMoves moves, one
+ *		bit per graph index
+ * Routes can end at a node holding another team's ship but can't go through
+ *		it. The start node itself is never set.
+ * Cached until the graph or any node's ship or owner changes; returns a copy,
+ *		as the cache may rehash or reset on the next call
+******************************************************************************/
+TBitArray<> UDMGalaxyPathfindingSubsystem::GetReachableNodes(const ADMGalaxyNode* pFrom, int32 MaxMoves, EDMPlayerTeam Team)
+{
+	const UDMGalaxyGraphSubsystem* pGraph = UpdateCache();
+	const int32 From = IsValid(pGraph) ? pGraph->GetNodeIndex(pFrom) : INDEX_NONE;
+	if (From == INDEX_NONE)
+	{
+		return TBitArray<>();
+	}
+
+	if (pGraph->GetBlockingGeneration() != CachedBlockingGeneration)
+	{
+		ReachableCache.Reset();
+		CachedBlockingGeneration = pGraph->GetBlockingGeneration();
+	}
+
+	const FIntVector Key(From, MaxMoves, (int32)Team);
+	if (const TBitArray<>* pCached = ReachableCache.Find(Key))
+	{
+		return *pCached;
+	}
+
+	DM_TURN_TRACE_SCOPE(ReachableNodes);
+
+	TBitArray<> Reachable(false, pGraph->GetNumNodes());
+
+	// BFS by layers, stopping after MaxMoves layers
+	TBitArray<> Visited(false, pGraph->GetNumNodes());
+	Visited[From] = true;
+	TArray<int32> Layer = { From };
+	TArray<int32> NextLayer;
+	for (int32 Move = 0; Move < MaxMoves && !Layer.IsEmpty(); ++Move)
+	{
+		NextLayer.Reset();
+		for (const int32 Current : Layer)
+		{
+			for (const int32 Neighbor : pGraph->GetNeighbors(Current))
+			{
+				if (Visited[Neighbor])
+				{
+					continue;
+				}
+				Visited[Neighbor] = true;
+				Reachable[Neighbor] = true;
+
+				// Another team's ship stops the route here
+				const ADMShip* pBlockingShip = pGraph->GetNode(Neighbor)->GetShip();
+				if (pBlockingShip == nullptr || UDMTeamComponent::GetActorsTeam(pBlockingShip) == Team)
+				{
+					NextLayer.Add(Neighbor);
+				}
+			}
+		}
+		Swap(Layer, NextLayer);
+	}
+
+	ReachableCache.Add(Key, Reachable);
+	return Reachable;
+}
+
+/*/////////////////////////////////////////////////////////////////////////////
+*	Internal Functions ////////////////////////////////////////////////////////
+*//////////////////////////////////////////////////////////////////////////////
+
+/******************************************************************************
+ * Throw away anything cached from an older graph
+ * returns the graph, or nullptr if there isn't one
+******************************************************************************/
+const UDMGalaxyGraphSubsystem* UDMGalaxyPathfindingSubsystem::UpdateCache()
+{
+	const UDMGalaxyGraphSubsystem* pGraph = UDMGalaxyGraphSubsystem::Get(this);
+	if (!IsValid(pGraph) || pGraph->GetGeneration() == CachedGeneration)
+	{
+		return pGraph;
+	}
+
+	DM_TURN_TRACE_SCOPE(PathfindingCache);
+
+	CachedGeneration = pGraph->GetGeneration();
+	const int32 NumNodes = pGraph->GetNumNodes();
+	ReachableCache.Reset();
+	AllPairs.Reset();
+	bAllPairsChecked = false;
+
+	// Heuristic data
+	NodeLocations.SetNumUninitialized(NumNodes);
+	for (int32 Node = 0; Node < NumNodes; ++Node)
+	{
+		NodeLocations[Node] = pGraph->GetNode(Node)->GetActorLocation();
+	}
+	MaxEdgeLength = 0.0;
+	for (int32 Edge = 0; Edge < pGraph->GetNumEdges(); ++Edge)
+	{
+		MaxEdgeLength = FMath::Max(MaxEdgeLength, FVector::Dist(NodeLocations[pGraph->GetEdgeStart(Edge)], NodeLocations[pGraph->GetEdgeEnd(Edge)]));
+	}
+
+	return pGraph;
+}
+
+/******************************************************************************
+ * Build the all pairs table if the galaxy is small enough and it isn't built
+ *		yet; only distance and route questions call this, so a game that
+ *		only asks for reachability never pays for it
+ * returns HasAllPairsTable
+******************************************************************************/
+bool UDMGalaxyPathfindingSubsystem::BuildAllPairsTable(const UDMGalaxyGraphSubsystem& Graph)
+{
+	if (bAllPairsChecked)
+	{
+		return HasAllPairsTable();
+	}
+	bAllPairsChecked = true;
+
+	// Past the limit NumNodes * NumNodes overflows int32
+	const int32 NumNodes = Graph.GetNumNodes();
+	if (NumNodes == 0 || NumNodes > FMath::Min(AllPairsMaxNodes, AllPairsNodeLimit))
+	{
+		return false;
+	}
+
+	DM_TURN_TRACE_SCOPE(PathfindingAllPairs);
+
+	// One BFS per row; each task writes only its own row
+	AllPairs.SetNumUninitialized(NumNodes * NumNodes);
+	ParallelFor(TEXT("DMPathfindingAllPairs"), NumNodes, BatchSize, [this, &Graph, NumNodes](int32 From)
+	{
+		TArray<int32> Distances;
+		BreadthFirst(Graph, From, Distances);
+
+		uint16* pRow = AllPairs.GetData() + From * NumNodes;
+		for (int32 To = 0; To < NumNodes; ++To)
+		{
+			pRow[To] = Distances[To] != INDEX_NONE ? (uint16)Distances[To] : UnreachableDistance;
+		}
+	});
+
+	return true;
+}
+
+/******************************************************************************
+ * Hop count from Start to every node, by graph index; INDEX_NONE where
+ *		unreachable
+******************************************************************************/
+void UDMGalaxyPathfindingSubsystem::BreadthFirst(const UDMGalaxyGraphSubsystem& Graph, int32 Start, TArray<int32>& OutDistances)
+{
+	OutDistances.Init(INDEX_NONE, Graph.GetNumNodes());
+	OutDistances[Start] = 0;
+
+	// Every node is queued at most once, so the queue is just an array with a read cursor
+	TArray<int32> Queue;
+	Queue.Reserve(Graph.GetNumNodes());
+	Queue.Add(Start);
+	for (int32 Cursor = 0; Cursor < Queue.Num(); ++Cursor)
+	{
+		const int32 Current = Queue[Cursor];
+		for (const int32 Neighbor : Graph.GetNeighbors(Current))
+		{
+			if (OutDistances[Neighbor] == INDEX_NONE)
+			{
+				OutDistances[Neighbor] = OutDistances[Current] + 1;
+				Queue.Add(Neighbor);
+			}
+		}
+	}
+}
+
+/******************************************************************************
+ * A* from Start to Goal
+ * Every move covers at most MaxEdgeLength, so straight line distance over it
+ *		never overestimates the moves left; the first time the goal comes off
+ *		the open list its route is a shortest one
+******************************************************************************/
+bool UDMGalaxyPathfindingSubsystem::AStar(const UDMGalaxyGraphSubsystem& Graph, int32 Start, int32 Goal, TArray<int32>& OutPath) const
+{
+	OutPath.Reset();
+
+	const int32 NumNodes = Graph.GetNumNodes();
+	const double InvMaxEdge = MaxEdgeLength > 0.0 ? 1.0 / MaxEdgeLength : 0.0;
+	const FVector& GoalLocation = NodeLocations[Goal];
+
+	struct FOpenNode
+	{
+		double Cost;
+		int32 Node;
+
+		bool operator<(const FOpenNode& Other) const	{ return Cost < Other.Cost; }
+	};
+
+	TArray<int32> Moves;
+	TArray<int32> Parents;
+	Moves.Init(MAX_int32, NumNodes);
+	Parents.Init(INDEX_NONE, NumNodes);
+
+	TArray<FOpenNode> Open;
+	Moves[Start] = 0;
+	Open.HeapPush({ FVector::Dist(NodeLocations[Start], GoalLocation) * InvMaxEdge, Start });
+
+	while (!Open.IsEmpty())
+	{
+		FOpenNode Current;
+		Open.HeapPop(Current, EAllowShrinking::No);
+		if (Current.Node == Goal)
+		{
+			for (int32 Node = Goal; Node != INDEX_NONE; Node = Parents[Node])
+			{
+				OutPath.Add(Node);
+			}
+			Algo::Reverse(OutPath);
+			return true;
+		}
+
+		// Stale entry; this node was reached more cheaply after it was pushed
+		const int32 NextMoves = Moves[Current.Node] + 1;
+		if (Current.Cost > Moves[Current.Node] + FVector::Dist(NodeLocations[Current.Node], GoalLocation) * InvMaxEdge)
+		{
+			continue;
+		}
+
+		for (const int32 Neighbor : Graph.GetNeighbors(Current.Node))
+		{
+			if (NextMoves < Moves[Neighbor])
+			{
+				Moves[Neighbor] = NextMoves;
+				Parents[Neighbor] = Current.Node;
+				Open.HeapPush({ NextMoves + FVector::Dist(NodeLocations[Neighbor], GoalLocation) * InvMaxEdge, Neighbor });
+			}
+		}
+	}
+
+	return false;
+}
+
+/******************************************************************************
+ * Distance lookup in the all pairs table; INDEX_NONE where unreachable
+******************************************************************************/
+int32 UDMGalaxyPathfindingSubsystem::GetTableDistance(int32 From, int32 To) const
+{
+	const uint16 Distance = AllPairs[From * NodeLocations.Num() + To];
+	return Distance != UnreachableDistance ? Distance : INDEX_NONE;
+}
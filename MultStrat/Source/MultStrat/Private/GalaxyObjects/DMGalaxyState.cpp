@@ -0,0 +1,465 @@
+// Copyright (c) 2025 William Pritz under MIT License
+
+
+#include "GalaxyObjects/DMGalaxyState.h"
+
+#include "Algo/BinarySearch.h"		// Algo::BinarySearch
+
+/*/////////////////////////////////////////////////////////////////////////////
+*	Setup /////////////////////////////////////////////////////////////////////
+*//////////////////////////////////////////////////////////////////////////////
+
+/******************************************************************************
+ * Add a node; returns its index
+******************************************************************************/
+int32 FDMGalaxyState::AddNode(EDMPlayerTeam Owner, bool bTakesShipTeam)
+{
+	NodeOwner.Add(Owner);
+	NodeTakesShipTeam.Add(bTakesShipTeam);
+	return NodeShip.Add(INDEX_NONE);
+}
+
+/******************************************************************************
+ * Add a ship docked at Node (may be INDEX_NONE); returns its index
+******************************************************************************/
+int32 FDMGalaxyState::AddShip(EDMPlayerTeam Team, int32 Power, int32 Node)
+{
+	const int32 Ship = ShipTeam.Add(Team);
+	ShipPower.Add(Power);
+	ShipNode.Add(Node);
+	ShipMoving.Add(false);
+	ShipAlive.Add(true);
+
+	if (Node != INDEX_NONE)
+	{
+		NodeShip[Node] = Ship;
+	}
+
+	return Ship;
+}
+
+/******************************************************************************
+ * Edges are indexed 0 to NumEdges - 1; clears their reservations
+******************************************************************************/
+void FDMGalaxyState::SetNumEdges(int32 NumEdges)
+{
+	EdgeReservation.Init(INDEX_NONE, NumEdges);
+}
+
+/******************************************************************************
+ * Move a ship along an edge towards Target, reserving the edge
+ * Same rules as UDMNodeConnectionComponent::ReserveShipTraversal: if another
+ *		ship already reserved the edge, that ship is sent home and this one
+ *		never leaves. Returns false on a bounce.
+******************************************************************************/
+bool FDMGalaxyState::AddMoveAlongEdge(int32 Ship, int32 Target, int32 Edge)
+{
+	const int32 ReservedMove = EdgeReservation[Edge];
+	if (ReservedMove != INDEX_NONE)
+	{
+		if (MoveShip[ReservedMove] != INDEX_NONE)
+		{
+			ShipMoving[MoveShip[ReservedMove]] = false;
+			MoveShip[ReservedMove] = INDEX_NONE;
+		}
+		return false;
+	}
+
+	EdgeReservation[Edge] = MoveShip.Num();
+	AddMove(Ship, Target, false);
+	return true;
+}
+
+/******************************************************************************
+ * Add a move with no reservation; a supporting ship adds its power without
+ *		moving
+******************************************************************************/
+void FDMGalaxyState::AddMove(int32 Ship, int32 Target, bool bSupporting)
+{
+	MoveShip.Add(Ship);
+	MoveTarget.Add(Target);
+	MoveSupporting.Add(bSupporting);
+
+	if (!bSupporting)
+	{
+		ShipMoving[Ship] = true;
+	}
+}
+
+/*/////////////////////////////////////////////////////////////////////////////
+*	Resolution ////////////////////////////////////////////////////////////////
+*//////////////////////////////////////////////////////////////////////////////
+
+/******************************************************************************
+ * Group pending moves by target and split the nodes with combat into
+ *		independent regions
+ * A ship links the node it is docked at with every node it is moving to, so
+ *		nodes in different regions can't affect each other.
+******************************************************************************/
+void FDMGalaxyState::BuildRegions()
+{
+	const int32 Nodes = NumNodes();
+	const int32 Ships = NumShips();
+
+	// Counting sort the moves by target; stable, so each node sees its moves in the order they were added
+	NodeNumPending.Init(0, Nodes);
+	for (int32 Move = 0; Move < MoveShip.Num(); ++Move)
+	{
+		if (MoveShip[Move] != INDEX_NONE)
+		{
+			++NodeNumPending[MoveTarget[Move]];
+		}
+	}
+
+	NodeFirstPending.SetNumUninitialized(Nodes);
+	int32 NumPending = 0;
+	for (int32 Node = 0; Node < Nodes; ++Node)
+	{
+		NodeFirstPending[Node] = NumPending;
+		NumPending += NodeNumPending[Node];
+	}
+
+	PendingShip.SetNumUninitialized(NumPending);
+	PendingSupporting.SetNumUninitialized(NumPending);
+	TArray<int32> NextPending = NodeFirstPending;
+	for (int32 Move = 0; Move < MoveShip.Num(); ++Move)
+	{
+		if (MoveShip[Move] != INDEX_NONE)
+		{
+			const int32 Slot = NextPending[MoveTarget[Move]]++;
+			PendingShip[Slot] = MoveShip[Move];
+			PendingSupporting[Slot] = MoveSupporting[Move];
+		}
+	}
+
+	NodeResults.Reset();
+	NodeResults.SetNum(Nodes);
+	NodeMargins.Init(0, Nodes);
+	NodeResultShip.Init(NodeResultUnset, Nodes);
+
+	// Union nodes with their ships; nodes come first, then ships
+	TArray<int32> Parents;
+	Parents.SetNumUninitialized(Nodes + Ships);
+	for (int32 i = 0; i < Parents.Num(); ++i)
+	{
+		Parents[i] = i;
+	}
+
+	auto FindRoot = [&Parents](int32 i)
+	{
+		while (Parents[i] != i)
+		{
+			Parents[i] = Parents[Parents[i]];
+			i = Parents[i];
+		}
+		return i;
+	};
+	auto Unite = [&Parents, &FindRoot](int32 A, int32 B)
+	{
+		A = FindRoot(A);
+		B = FindRoot(B);
+		Parents[FMath::Max(A, B)] = FMath::Min(A, B);
+	};
+
+	for (int32 Ship = 0; Ship < Ships; ++Ship)
+	{
+		if (ShipNode[Ship] != INDEX_NONE)
+		{
+			Unite(ShipNode[Ship], Nodes + Ship);
+		}
+	}
+	for (int32 Node = 0; Node < Nodes; ++Node)
+	{
+		for (int32 Slot = NodeFirstPending[Node]; Slot < NodeFirstPending[Node] + NodeNumPending[Node]; ++Slot)
+		{
+			Unite(Node, Nodes + PendingShip[Slot]);
+		}
+	}
+
+	// Roots always have the lowest index, so regions come out in node order
+	Regions.Reset();
+	TArray<int32> RegionOfRoot;
+	RegionOfRoot.Init(INDEX_NONE, Nodes);
+	for (int32 Node = 0; Node < Nodes; ++Node)
+	{
+		if (NodeNumPending[Node] == 0)
+		{
+			continue;
+		}
+
+		int32& RegionIndex = RegionOfRoot[FindRoot(Node)];
+		if (RegionIndex == INDEX_NONE)
+		{
+			RegionIndex = Regions.AddDefaulted();
+		}
+		Regions[RegionIndex].Add(Node);
+	}
+}
+
+/******************************************************************************
+ * Resolve every node in one region in move dependency order, one "round" at a
+ *		time
+ * A node whose docked ship is leaving waits for the ship's destination; the
+ *		ship may win there and leave. Nodes unblocked during a round resolve
+ *		in the next one, and each round goes in node order. When only cycles
+ *		are left (ships swapping or rotating between nodes) they're all broken
+ *		at once, in node order.
+ * Regions share no nodes or ships, so they may resolve concurrently
+******************************************************************************/
+void FDMGalaxyState::ResolveRegion(int32 RegionIndex)
+{
+	TArray<int32>& Region = Regions[RegionIndex];
+
+	TArray<int32> ResolveOrder;
+	ResolveOrder.Reserve(Region.Num());
+
+	TArray<bool> Resolved;
+	Resolved.Init(false, Region.Num());
+	auto IsResolved = [&Region, &Resolved](int32 Node)
+	{
+		return Resolved[Algo::BinarySearch(Region, Node)];
+	};
+
+	TArray<int32> ReadyNodes;
+	TArray<int32> NextReadyNodes;
+	TMap<int32, int32> BlockedNodes;
+	for (int32 Node : Region)
+	{
+		if (CanResolve(Node))
+		{
+			ReadyNodes.Add(Node);
+		}
+		else
+		{
+			BlockedNodes.Add(NodeShip[Node], Node);
+		}
+	}
+
+	while (ResolveOrder.Num() < Region.Num())
+	{
+		// Only cycles remain; break them all at once in node order
+		if (ReadyNodes.IsEmpty())
+		{
+			for (int32 i = 0; i < Region.Num(); ++i)
+			{
+				if (!Resolved[i])
+				{
+					ReadyNodes.Add(Region[i]);
+				}
+			}
+			BlockedNodes.Reset();
+		}
+
+		for (int32 Node : ReadyNodes)
+		{
+			ResolveNode(Node);
+			Resolved[Algo::BinarySearch(Region, Node)] = true;
+			ResolveOrder.Add(Node);
+
+			// The winner may have just left the node that was waiting on it
+			int32 WaitingNode = INDEX_NONE;
+			if (NodeShip[Node] != INDEX_NONE &&
+				BlockedNodes.RemoveAndCopyValue(NodeShip[Node], WaitingNode) &&
+				!IsResolved(WaitingNode) &&
+				CanResolve(WaitingNode))
+			{
+				NextReadyNodes.Add(WaitingNode);
+			}
+		}
+
+		Swap(ReadyNodes, NextReadyNodes);
+		NextReadyNodes.Reset();
+		ReadyNodes.Sort();
+	}
+
+	Region = MoveTemp(ResolveOrder);
+}
+
+/******************************************************************************
+ * BuildRegions, then resolve every region on this thread
+******************************************************************************/
+void FDMGalaxyState::Resolve()
+{
+	BuildRegions();
+	for (int32 RegionIndex = 0; RegionIndex < Regions.Num(); ++RegionIndex)
+	{
+		ResolveRegion(RegionIndex);
+	}
+}
+
+/******************************************************************************
+ * Check all pending ships and see if the math works out where no matter what
+ *		happens in other combats, this node can safely resolve
+******************************************************************************/
+bool FDMGalaxyState::CanResolve(int32 Node)
+{
+	// 1; No pending ships = resolvable
+	if (NodeNumPending[Node] == 0)
+	{
+		return true;
+	}
+
+	// 2: Current ship on node is Not Moving or DNE  = resolvable
+	const int32 CurrentShip = NodeShip[Node];
+	if (CurrentShip == INDEX_NONE || !ShipMoving[CurrentShip])
+	{
+		return true;
+	}
+
+	// 3; current ship Does not matter for result (win or tie for home team without it)  = resolvable
+	int32 PowerDiff = 0;
+	const FNodeResult& Result = GetNodeResult(Node, PowerDiff);
+	return Result.Winner == NodeOwner[Node] && PowerDiff >= ShipPower[CurrentShip];
+}
+
+/******************************************************************************
+ * NodeResults[Node], worked out again only if the node's docked ship changed
+ *		since
+ * A node's result only depends on its pending moves, which are fixed once
+ *		the turn starts resolving, and on its live docked ship. So the check
+ *		when the region is set up, the check when the node is woken and the
+ *		resolve itself share one GetPendingPowers unless the ship left or died
+ *		in between.
+******************************************************************************/
+const FDMGalaxyState::FNodeResult& FDMGalaxyState::GetNodeResult(int32 Node, int32& OutMargin)
+{
+	const int32 CurrentShip = NodeShip[Node];
+	const int32 LiveShip = CurrentShip != INDEX_NONE && ShipAlive[CurrentShip] ? CurrentShip : INDEX_NONE;
+	if (NodeResultShip[Node] != LiveShip)
+	{
+		GetPendingPowers(Node, NodeResults[Node], NodeMargins[Node]);
+		NodeResultShip[Node] = LiveShip;
+	}
+
+	OutMargin = NodeMargins[Node];
+	return NodeResults[Node];
+}
+
+/******************************************************************************
+ * Every team's main attacking ship and total power at a node, and the winner
+ * Pending ships count in the order their moves were added, so callers that
+ *		need every machine to agree must add moves in the same order (see
+ *		UDMPlanetProcessingSubsystem::CaptureCombatNode)
+******************************************************************************/
+void FDMGalaxyState::GetPendingPowers(int32 Node, FNodeResult& OutResult, int32& OutMargin) const
+{
+	for (int32 Team = 0; Team < NumTeams; ++Team)
+	{
+		OutResult.Ships[Team] = INDEX_NONE;
+		OutResult.Powers[Team] = 0;
+	}
+	OutResult.InvolvedTeams = 0;
+
+	// Account for the current ship on the node (if there is one)
+	const int32 CurrentShip = NodeShip[Node];
+	if (CurrentShip != INDEX_NONE && ShipAlive[CurrentShip])
+	{
+		const int32 Team = (int32)ShipTeam[CurrentShip];
+		OutResult.Ships[Team] = CurrentShip;
+		OutResult.Powers[Team] = 1;
+		OutResult.InvolvedTeams |= 1u << Team;
+	}
+
+	for (int32 Slot = NodeFirstPending[Node]; Slot < NodeFirstPending[Node] + NodeNumPending[Node]; ++Slot)
+	{
+		const int32 Ship = PendingShip[Slot];
+		const bool bSupporting = PendingSupporting[Slot];
+		const int32 Team = (int32)ShipTeam[Ship];
+
+		// Attacker: No previous attacker -> Add the team
+		// Supporter: No previous attacker -> Add the team
+		// Attacker: Yes previous attacker -> Take over as the main attacker
+		// Supporter: Yes previous attacker -> increment power
+		if (!OutResult.IsInvolved(Team))
+		{
+			OutResult.Ships[Team] = bSupporting ? INDEX_NONE : Ship;
+			OutResult.Powers[Team] = ShipPower[Ship];
+			OutResult.InvolvedTeams |= 1u << Team;
+		}
+		else if (bSupporting)
+		{
+			++OutResult.Powers[Team];
+		}
+		else if (OutResult.Ships[Team] != INDEX_NONE)
+		{
+			OutResult.Ships[Team] = Ship;
+			++OutResult.Powers[Team];
+		}
+		// Just ignore the ship if there are multiple attackers
+		// TMDOTO: Imagine a situation:
+		// Planet A (Team1) has a ship of power 1
+		// Planet B (Team1) has a ship of power 1
+		// Planet C (Team2)has a ship of power 2
+		// 
+		// C Is attacking A
+		// A's ship wants to move to some planet D, but doesn't know if it will bounce
+		// if A bounces and B Supports A, A defends successfully
+		// if A bounces and B Moves to A, A fails defense (B cannot move to A, power not counted)
+		// Note; it's not like team 1 will KNOW C is attacking A, so they wont know; move or support?
+	}
+
+	OutMargin = OutResult.FindWinner();
+}
+
+/******************************************************************************
+ * Set Winner to the strongest team with an attacking ship; Invalid on a tie
+ * returns how far ahead of the next team the winner is (0 on a tie)
+******************************************************************************/
+int32 FDMGalaxyState::FNodeResult::FindWinner()
+{
+	int32 Highest = 0;
+	int32 SecondHighest = 0;
+	int32 WinningTeam = (int32)EDMPlayerTeam::Invalid;
+	for (int32 Team = 0; Team < NumTeams; ++Team)
+	{
+		// Teams that are only supporting can't take the node
+		const int32 Power = Ships[Team] != INDEX_NONE ? Powers[Team] : 0;
+		const bool bHigher = Power > Highest;
+
+		SecondHighest = bHigher ? Highest : FMath::Max(SecondHighest, Power);
+		WinningTeam = bHigher ? Team : (Power == Highest ? (int32)EDMPlayerTeam::Invalid : WinningTeam);
+		Highest = bHigher ? Power : Highest;
+	}
+
+	Winner = (EDMPlayerTeam)WinningTeam;
+	return WinningTeam != (int32)EDMPlayerTeam::Invalid ? Highest - SecondHighest : 0;
+}
+
+/******************************************************************************
+ * The loser is destroyed, and the winner leaves its home for this node
+ *		(unless it was already destroyed elsewhere); planets take the winner's
+ *		team
+******************************************************************************/
+void FDMGalaxyState::ResolveNode(int32 Node)
+{
+	int32 WinningMargin = 0;
+	const FNodeResult& Result = GetNodeResult(Node, WinningMargin);
+	if (Result.Winner == EDMPlayerTeam::Invalid)
+	{
+		return;
+	}
+
+	const int32 WinningShip = Result.Ships[(int32)Result.Winner];
+	const int32 CurrentShip = NodeShip[Node];
+	if (CurrentShip != INDEX_NONE && ShipAlive[CurrentShip] && CurrentShip != WinningShip)
+	{
+		ShipAlive[CurrentShip] = false;
+	}
+
+	if (!ShipAlive[WinningShip])
+	{
+		return;
+	}
+
+	if (ShipNode[WinningShip] != INDEX_NONE)
+	{
+		NodeShip[ShipNode[WinningShip]] = INDEX_NONE;
+	}
+	ShipNode[WinningShip] = Node;
+	NodeShip[Node] = WinningShip;
+
+	if (NodeTakesShipTeam[Node])
+	{
+		NodeOwner[Node] = ShipTeam[WinningShip];
+	}
+}
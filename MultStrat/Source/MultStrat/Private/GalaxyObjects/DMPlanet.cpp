@@ -2,7 +2,9 @@
 
 
 #include "GalaxyObjects/DMPlanet.h"		// Base Class Definition
+#include "GameSettings/DMGameMode.h"	// ADMGameMode
 #include "GameSettings/DMGameState.h"	// ADMGameState
+#include "GameSettings/DMTurnTrace.h"	// TRACE_COUNTER_INCREMENT
 #include "Components/DMTeamComponent.h"	// EDMPlayerTeam
 #include "Net/UnrealNetwork.h"			// DOREPLIFETIME
 #include "Player/DMShip.h"				// ADMShip
@@ -17,6 +19,16 @@ void ADMPlanet::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetim
 	DOREPLIFETIME(ADMPlanet, OwningPlayer);
 }
 
+/******************************************************************************
+ * Lockstep machines resolve ownership themselves; stop replicating it
+******************************************************************************/
+void ADMPlanet::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) /* override */
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	DOREPLIFETIME_ACTIVE_OVERRIDE(ADMPlanet, OwningPlayer, !ADMGameState::IsLockstep(this));
+}
+
 /*/////////////////////////////////////////////////////////////////////////////
 *	Ship Management ///////////////////////////////////////////////////////////
 *//////////////////////////////////////////////////////////////////////////////
@@ -27,18 +39,45 @@ void ADMPlanet::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetim
  * Server Function
 ******************************************************************************/
 void ADMPlanet::K2_SpawnShip_Implementation(TSubclassOf<ADMShip> Ship, EDMPlayerTeam Team)
+{
+	SpawnShip(Ship, Team);
+}
+
+/******************************************************************************
+ * Spawn a ship of the given type docked at this planet; returns nullptr if
+ *		the planet already has a ship
+ * Ships come from the game mode's pool when it has one of the right class.
+ *		In lockstep every machine spawns its own copy, so the ship isn't
+ *		replicated
+******************************************************************************/
+ADMShip* ADMPlanet::SpawnShip(TSubclassOf<ADMShip> Ship, EDMPlayerTeam Team)
 {
 	// Can we?
 	if (HasShip() || Ship == nullptr)
 	{
-		return;
+		return nullptr;
+	}
+
+	// Do it; reuse a ship lost in combat if the game mode has one pooled
+	ADMShip* NewShip = nullptr;
+	UWorld* pWorld = GetWorld();
+	if (ADMGameMode* pGameMode = pWorld->GetAuthGameMode<ADMGameMode>())
+	{
+		NewShip = pGameMode->AcquireShip(Ship);
+	}
+	else
+	{
+		// Lockstep clients have no game mode, and so no pool
+		NewShip = pWorld->SpawnActorDeferred<ADMShip>(Ship, FTransform::Identity);
+		NewShip->SetReplicates(false);
+		NewShip->FinishSpawning(FTransform::Identity);
 	}
 
-	// Do it
-	ADMShip* NewShip = GetWorld()->SpawnActor<ADMShip>(Ship);
 	NewShip->TeamComponent->SetTeam(Team);
 	NewShip->SetOwningPlayer(OwningPlayer);
 	SetCurrentShip(NewShip);
+
+	return NewShip;
 }
 
 /*/////////////////////////////////////////////////////////////////////////////
@@ -52,7 +91,7 @@ void ADMPlanet::SetCurrentShip(ADMShip* NewShip) /* override */
 {
 	Super::SetCurrentShip(NewShip);
 
-	if (!HasAuthority())
+	if (!HasAuthority() && !ADMGameState::IsLockstep(this))
 	{
 		// Debug in parent
 		return;
@@ -67,5 +106,6 @@ void ADMPlanet::SetCurrentShip(ADMShip* NewShip) /* override */
 	{
 		EDMPlayerTeam NewTeam = TeamComponent->SetTeam(NewShip->TeamComponent->GetTeam());
 		OwningPlayer = NewShip->GetOwningPlayer();
+		TRACE_COUNTER_INCREMENT(DMTurn_OwnershipChanges);
 	}
 }
\ No newline at end of file
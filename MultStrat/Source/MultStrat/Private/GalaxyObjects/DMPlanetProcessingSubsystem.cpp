@@ -3,11 +3,16 @@
 
 #include "GalaxyObjects/DMPlanetProcessingSubsystem.h"
 
-#include "Components\DMNodeConnectionComponent.h"	// ADMConnector
-#include "Kismet/GameplayStatics.h"					// UGameplayStatics
+#include "Async/ParallelFor.h"						// ParallelFor
+#include "Components/DMCommandFlagsComponent.h"		// ECommandFlags
+#include "GalaxyObjects/DMGalaxyGraphSubsystem.h"	// UDMGalaxyGraphSubsystem
 #include "GalaxyObjects/DMGalaxyNode.h"				// ADMGalaxyNode
+#include "GalaxyObjects/DMGalaxyState.h"			// FDMGalaxyState
+#include "GalaxyObjects/DMPlanet.h"					// ADMPlanet
+#include "GameSettings/DMGameState.h"				// ADMGameState
 #include "Player/DMShip.h"							// ADMShip
-#include "Components/DMCommandFlagsComponent.h"		// UDMCommandComponent
+#include "GameSettings/DMTurnEventLog.h"				// FDMTurnEventLog
+#include "GameSettings/DMTurnTrace.h"					// DM_TURN_TRACE_SCOPE
 
 
 /******************************************************************************
@@ -65,15 +70,45 @@ TStatId UDMPlanetProcessingSubsystem::GetStatId() const
 *	Planet Processing Functions ///////////////////////////////////////////////
 *//////////////////////////////////////////////////////////////////////////////
 
+/******************************************************************************
+ * Nodes touched this turn (ships pending, ships placed); only these are
+ *		visited when resolving
+******************************************************************************/
+void UDMPlanetProcessingSubsystem::MarkNodeDirty(ADMGalaxyNode* pNode)
+{
+	DirtyNodes.Add(pNode);
+}
+
 /******************************************************************************
  * Called when the subsystem should start moving/animating planets
 ******************************************************************************/
 void UDMPlanetProcessingSubsystem::StartProcessingPlanetResults()
 {
+	const ADMGameState* pGameState = ADMGameState::Get(this);
+	ProcessingTurnNumber = pGameState != nullptr ? pGameState->GetTurnNumber() : 0;
+
 	CurrentStage = EProcessingStage::MoveShips;
+	bProcessingTurn = true;
 	SetTickableTickType(ETickableTickType::Always);
 }
 
+/******************************************************************************
+ * Resolve whatever is left of the current turn right now, ignoring the frame
+ *		budget
+ * Lockstep clients call this when the next turn's commands arrive before this
+ *		turn finished resolving
+******************************************************************************/
+void UDMPlanetProcessingSubsystem::FinishProcessingTurn()
+{
+	DM_TURN_TRACE_SCOPE(FinishProcessingTurn);
+
+	TGuardValue<bool> IgnoreBudget(bIgnoreFrameBudget, true);
+	while (bProcessingTurn)
+	{
+		Tick(0.0f);
+	}
+}
+
 /******************************************************************************
  * Let the planets start moving their respective ships to them
 ******************************************************************************/
@@ -85,67 +120,281 @@ void UDMPlanetProcessingSubsystem::MovePendingShipsToPlanets()
 
 /******************************************************************************
  * Let the planets resolve their combat
+ * The turn is copied into a FDMGalaxyState node by node, resolved there region
+ *		by region (a batch of regions at a time on worker threads for large
+ *		turns), and the results are then applied to the nodes in resolve
+ *		order. Servers do all of it in a single pass; clients stop at any of
+ *		those steps when their frame budget runs out and pick up where they
+ *		left off next tick.
 ******************************************************************************/
 void UDMPlanetProcessingSubsystem::ProcessPlanetCombat()
 {
-	// DMTODO: This should be all dirty galaxynodes, that register themselves when commands run
-	TArray<AActor*> AllGalaxyNodes;
-	UGameplayStatics::GetAllActorsOfClass(this, ADMGalaxyNode::StaticClass(), AllGalaxyNodes);
+	DM_TURN_TRACE_SCOPE(ProcessPlanetCombat);
+	TRACE_COUNTER_INCREMENT(DMTurn_CombatIterations);
 
-	// keep track as to whether we're going to finish resolving all nodes this cycle
-	bool NodeProcessingFinished = true;
+	UWorld* pWorld = GetWorld();
+	const bool bUseBudget = !bIgnoreFrameBudget && ClientCombatFrameBudgetMs > 0.0f && IsValid(pWorld) && pWorld->GetNetMode() == NM_Client;
+	const double Deadline = FPlatformTime::Seconds() + ClientCombatFrameBudgetMs / 1000.0;
+	auto OutOfTime = [bUseBudget, Deadline]()
+	{
+		return bUseBudget && FPlatformTime::Seconds() >= Deadline;
+	};
+
+	if (!bCombatStarted)
+	{
+		GatherCombatNodes();
+		BeginCombatCapture();
+	}
 
-	// Find all resolveable nodes
-	TArray<ADMGalaxyNode*> ResolveableNodes;
-	for (AActor* pCurr : AllGalaxyNodes)
+	// Copy the turn into CombatState
+	while (CaptureCursor < CombatNodes.Num())
 	{
-		ADMGalaxyNode* pNode = Cast<ADMGalaxyNode>(pCurr);
-		if (!pNode->CommandsComponent->CheckForCommandFlags(ECommandFlags::Resolved))
+		CaptureCombatNode(CaptureCursor++);
+		if (OutOfTime())
+		{
+			return;
+		}
+	}
+
+	if (!bRegionsBuilt)
+	{
+		DM_TURN_TRACE_SCOPE(BuildCombatRegions);
+		CombatState.BuildRegions();
+		bRegionsBuilt = true;
+
+		// Nodes whose pending ships were all out of the game have no combat after all
+		NumCombats = 0;
+		for (const TArray<int32>& Region : CombatState.Regions)
+		{
+			NumCombats += Region.Num();
+		}
+		NumUnresolvedCombats = NumCombats;
+
+		if (OutOfTime())
 		{
-			if (pNode->CanResolveTurn())
-			{
-				ResolveableNodes.Add(pNode);
-				pNode->CommandsComponent->AddCommandFlags(ECommandFlags::Resolved);
-			}
-			else
-			{
-				NodeProcessingFinished = false;
-			}
+			return;
 		}
 	}
 
-	// if no nodes are resolveable, resolve all remaining unresolved nodes
-	if (ResolveableNodes.IsEmpty())
+	// Work out the results
+	while (RegionCursor < CombatState.Regions.Num())
 	{
-		NodeProcessingFinished = true;
-		for (AActor* pCurr : AllGalaxyNodes)
+		ResolveCombatRegions(bUseBudget);
+		if (OutOfTime())
 		{
-			ADMGalaxyNode* pNode = Cast<ADMGalaxyNode>(pCurr);
-			if (!pNode->CommandsComponent->CheckForCommandFlags(ECommandFlags::Resolved))
-			{
-				ResolveableNodes.Add(pNode);
-				pNode->CommandsComponent->AddCommandFlags(ECommandFlags::Resolved);
-			}
+			return;
 		}
 	}
-	
-	// Resolve nodes
-	for (ADMGalaxyNode* pNode : ResolveableNodes)
+
+	// Apply them to the actors
+	while (ApplyCursor < ApplyOrder.Num())
 	{
-		pNode->ResolveTurn();
+		ApplyCombatResult(ApplyOrder[ApplyCursor++]);
+		--NumUnresolvedCombats;
+
+		// Out of time; carry on next tick
+		if (NumUnresolvedCombats > 0 && OutOfTime())
+		{
+			return;
+		}
 	}
 
-	// if all nodes resolved, move to next step
-	if (NodeProcessingFinished)
+	CombatNodes.Reset();
+	CombatShips.Reset();
+	CombatState = FDMGalaxyState();
+	CaptureNodeIndices.Reset();
+	CaptureShipIndices.Reset();
+	CaptureCursor = 0;
+	bRegionsBuilt = false;
+	RegionCursor = 0;
+	ApplyOrder.Reset();
+	ApplyCursor = 0;
+	bCombatStarted = false;
+
+	ProcessingFinished();
+}
+
+/******************************************************************************
+ * Collect the dirty nodes with combat this turn, in resolve order
+******************************************************************************/
+void UDMPlanetProcessingSubsystem::GatherCombatNodes()
+{
+	// Only nodes touched this turn with ships incoming can have combat; visit them in name order so every machine agrees
+	CombatNodes.Reset(DirtyNodes.Num());
+	for (ADMGalaxyNode* pNode : DirtyNodes)
 	{
-		for (AActor* pCurr : AllGalaxyNodes)
+		if (IsValid(pNode) && pNode->HasPendingShips())
 		{
-			ADMGalaxyNode* pNode = Cast<ADMGalaxyNode>(pCurr);
-			pNode->CommandsComponent->RemoveCommandFlags(ECommandFlags::Resolved);
+			CombatNodes.Add(pNode);
 		}
-		ProcessingFinished();
 	}
+	CombatNodes.Sort([](const ADMGalaxyNode& A, const ADMGalaxyNode& B)
+	{
+		return A.GetFName().Compare(B.GetFName()) < 0;
+	});
 
+	NumCombats = CombatNodes.Num();
+	NumUnresolvedCombats = NumCombats;
+	bCombatStarted = true;
+}
+
+/******************************************************************************
+ * Resolve the next regions of CombatState and line their results up to be
+ *		applied
+ * Large turns resolve a batch of regions on worker threads at a time; the
+ *		whole turn when there's no frame budget. Applying every region's
+ *		results in its resolve order leaves ships and nodes exactly as
+ *		resolving node by node would; events are grouped by region instead of
+ *		interleaved.
+******************************************************************************/
+void UDMPlanetProcessingSubsystem::ResolveCombatRegions(bool bUseBudget)
+{
+	DM_TURN_TRACE_SCOPE(ResolveCombat);
+
+	const int32 FirstRegion = RegionCursor;
+	if (bParallelCombatResolution && CombatNodes.Num() >= ParallelCombatMinNodes)
+	{
+		const int32 RegionsLeft = CombatState.Regions.Num() - FirstRegion;
+		const int32 NumRegions = bUseBudget ? FMath::Min(FMath::Max(ClientCombatRegionBatch, 1), RegionsLeft) : RegionsLeft;
+		ParallelFor(NumRegions, [this, FirstRegion](int32 i)
+		{
+			DM_TURN_TRACE_SCOPE(ResolveCombatRegion);
+			CombatState.ResolveRegion(FirstRegion + i);
+		});
+		RegionCursor += NumRegions;
+	}
+	else
+	{
+		CombatState.ResolveRegion(RegionCursor++);
+	}
+
+	for (int32 RegionIndex = FirstRegion; RegionIndex < RegionCursor; ++RegionIndex)
+	{
+		ApplyOrder.Append(CombatState.Regions[RegionIndex]);
+	}
+}
+
+/******************************************************************************
+ * Apply one node's result from the combat state to the actors
+******************************************************************************/
+void UDMPlanetProcessingSubsystem::ApplyCombatResult(int32 NodeIndex)
+{
+	const FDMGalaxyState::FNodeResult& Result = CombatState.NodeResults[NodeIndex];
+
+	FDMTeamPowers Powers;
+	Powers.InvolvedTeams = Result.InvolvedTeams;
+	for (int32 Team = 0; Team < FDMTeamPowers::NumTeams; ++Team)
+	{
+		Powers.Ships[Team] = Result.Ships[Team] != INDEX_NONE ? CombatShips[Result.Ships[Team]].Get() : nullptr;
+		Powers.Powers[Team] = (size_t)Result.Powers[Team];
+	}
+
+	CombatNodes[NodeIndex]->ApplyTurnResult(Powers, Result.Winner);
+}
+
+/******************************************************************************
+ * Start copying the turn into CombatState: every combat node, so ships
+ *		docked at any of them can find their home; CaptureCombatNode adds
+ *		the ships and moves
+ * State node indices match CombatNodes
+******************************************************************************/
+void UDMPlanetProcessingSubsystem::BeginCombatCapture()
+{
+	DM_TURN_TRACE_SCOPE(BeginCombatCapture);
+
+	CaptureNodeIndices.Reset();
+	CaptureNodeIndices.Reserve(CombatNodes.Num());
+	for (ADMGalaxyNode* pNode : CombatNodes)
+	{
+		CaptureNodeIndices.Add(pNode, CombatState.AddNode(pNode->TeamComponent->GetTeam(), pNode->IsA<ADMPlanet>()));
+	}
+
+	CaptureShipIndices.Reset();
+	CaptureCursor = 0;
+	bRegionsBuilt = false;
+	RegionCursor = 0;
+	ApplyOrder.Reset(CombatNodes.Num());
+	ApplyCursor = 0;
+}
+
+/******************************************************************************
+ * Copy one combat node's docked ship and pending moves into CombatState
+ * CombatShips maps state ship indices back to the actors. Ships are added in
+ *		the same order on every machine. Moves have already reserved their
+ *		edges.
+******************************************************************************/
+void UDMPlanetProcessingSubsystem::CaptureCombatNode(int32 NodeIndex)
+{
+	auto FindOrAddShip = [this](ADMShip* pShip) -> int32
+	{
+		if (const int32* pFound = CaptureShipIndices.Find(pShip))
+		{
+			return *pFound;
+		}
+
+		// Ships docked outside the combat nodes can still leave; their old node just isn't part of the state
+		const int32* pHome = CaptureNodeIndices.Find(pShip->GetCurrentNode());
+		const int32 ShipIndex = CombatState.AddShip(pShip->TeamComponent->GetTeam(), pShip->GetShipPower(), pHome != nullptr ? *pHome : INDEX_NONE);
+		CombatState.ShipMoving[ShipIndex] = pShip->CommandsComponent->CheckForCommandFlags(ECommandFlags::MovingShip);
+		CombatShips.Add(pShip);
+		return CaptureShipIndices.Add(pShip, ShipIndex);
+	};
+
+	ADMGalaxyNode* pNode = CombatNodes[NodeIndex];
+	if (IsValid(pNode->GetShip()) && pNode->GetShip()->IsShipActive())
+	{
+		CombatState.NodeShip[NodeIndex] = FindOrAddShip(pNode->GetShip());
+	}
+
+	// Pending ships come out in whatever order they were added, which differs between the server and lockstep
+	//		clients; move order decides the main attacker, so add them by the name of the node they're leaving
+	TArray<TPair<ADMShip*, bool>> PendingShips;
+	PendingShips.Reserve(pNode->GetPendingShips().Num());
+	for (const TPair<TObjectPtr<ADMShip>, bool>& AttemptedShip : pNode->GetPendingShips())
+	{
+		// Pooled ships are still valid, but are out of the game
+		if (IsValid(AttemptedShip.Key) && AttemptedShip.Key->IsShipActive())
+		{
+			PendingShips.Emplace(AttemptedShip.Key.Get(), AttemptedShip.Value);
+		}
+	}
+	PendingShips.Sort([](const TPair<ADMShip*, bool>& A, const TPair<ADMShip*, bool>& B)
+	{
+		const ADMGalaxyNode* pHomeA = A.Key->GetCurrentNode();
+		const ADMGalaxyNode* pHomeB = B.Key->GetCurrentNode();
+		if (pHomeA == nullptr || pHomeB == nullptr)
+		{
+			return pHomeA != nullptr;
+		}
+		return pHomeA->GetFName().Compare(pHomeB->GetFName()) < 0;
+	});
+
+	for (const TPair<ADMShip*, bool>& AttemptedShip : PendingShips)
+	{
+		// AddMove would flag the ship as moving; keep the flag the actor really has
+		const int32 ShipIndex = FindOrAddShip(AttemptedShip.Key);
+		const bool bMoving = CombatState.ShipMoving[ShipIndex];
+		CombatState.AddMove(ShipIndex, NodeIndex, AttemptedShip.Value);
+		CombatState.ShipMoving[ShipIndex] = bMoving;
+	}
+}
+
+/******************************************************************************
+ * Fraction of this turn's combats resolved so far, 0 to 1; 1 when no turn is
+ *		processing
+******************************************************************************/
+float UDMPlanetProcessingSubsystem::GetCombatProgress() const
+{
+	if (!bProcessingTurn)
+	{
+		return 1.0f;
+	}
+	if (!bCombatStarted)
+	{
+		return 0.0f;
+	}
+
+	return NumCombats > 0 ? 1.0f - (float)NumUnresolvedCombats / NumCombats : 1.0f;
 }
 
 /******************************************************************************
@@ -153,15 +402,25 @@ void UDMPlanetProcessingSubsystem::ProcessPlanetCombat()
 ******************************************************************************/
 void UDMPlanetProcessingSubsystem::ProcessingFinished()
 {
-	// DMTODO: This should be all dirty Connectors, that register themselves when commands run
-	TArray<AActor*> AllConnectors;
-	UGameplayStatics::GetAllActorsOfClass(this, ADMConnector::StaticClass(), AllConnectors);
+	DM_TURN_TRACE_SCOPE(ProcessingFinished);
+
+	// Everything touched this turn has been resolved
+	if (UDMGalaxyGraphSubsystem* pGraph = UDMGalaxyGraphSubsystem::Get(this))
+	{
+		pGraph->ClearEdgeReservations();
+	}
+	DirtyNodes.Reset();
+
+	// Hand this turn's combat events to the log
+	FDMTurnEventLog::Get(this).Flush();
 
-	for (AActor* pConnector : AllConnectors)
+	// Let the game state publish (server) or check (client) where the galaxy ended up
+	if (ADMGameState* pGameState = ADMGameState::Get(this))
 	{
-		Cast<ADMConnector>(pConnector)->SetTraversingShip(nullptr);
+		pGameState->TurnResolved(ProcessingTurnNumber, GalaxyHash);
 	}
 
 	// we don't need to tick anymore, we've finished processing
+	bProcessingTurn = false;
 	SetTickableTickType(ETickableTickType::Never);
 }
@@ -5,6 +5,7 @@
 #include "GameSettings/DMGameState.h"	// ADMGameState
 #include "Components/DMTeamComponent.h"	// EDMPlayerTeam
 #include "Commands\DMCommand.h"			// UDMCommand
+#include "Player/DMShip.h"				// ADMShip
 
 
 /******************************************************************************
@@ -19,6 +20,8 @@ void ADMGameMode::InitGameState() /* override */
 	if (ADMGameState* Currstate = Cast<ADMGameState>(GameState))
 	{
 		Currstate->CurrentTeamData = TeamDataAsset;
+		Currstate->CurrentCommandsData = CommandsDataAsset;
+		Currstate->bLockstepTurns = bLockstepTurns;
 		Currstate->NextNewTeam = EDMPlayerTeam::TeamOne;
 	}
 }
@@ -27,6 +30,8 @@ void ADMGameMode::InitGameState() /* override */
  * AGameModeBase Override
  *
  * Check max # of players before allowing a login
+ * Lockstep games can't be joined once the first turn has run; clients only
+ *		get each turn's commands, never the galaxy they were run against
 ******************************************************************************/
 void ADMGameMode::PreLogin(const FString& Options, const FString& Address, const FUniqueNetIdRepl& UniqueId, FString& ErrorMessage) /* override */
 {
@@ -36,6 +41,13 @@ void ADMGameMode::PreLogin(const FString& Options, const FString& Address, const
 		return;
 	}
 
+	const ADMGameState* pGameState = GetGameState<ADMGameState>();
+	if (bLockstepTurns && pGameState != nullptr && pGameState->GetTurnNumber() > 0)
+	{
+		ErrorMessage = "Game already in progress!";
+		return;
+	}
+
 	Super::PreLogin(Options, Address, UniqueId, ErrorMessage);
 }
 
@@ -125,3 +137,66 @@ float ADMGameMode::GetShipSpawnZOffset() const
 
 	return CommandsDataAsset->ShipSpawnZOffset;
 }
+
+/*/////////////////////////////////////////////////////////////////////////////
+*	Ship Pooling //////////////////////////////////////////////////////////////
+*//////////////////////////////////////////////////////////////////////////////
+
+/******************************************************************************
+ * Get an active ship of the given class; reuses a pooled ship when one is
+ *		available
+ * The caller sets its team and owner and docks it at a node
+******************************************************************************/
+ADMShip* ADMGameMode::AcquireShip(TSubclassOf<ADMShip> ShipClass)
+{
+	if (ShipClass == nullptr)
+	{
+		return nullptr;
+	}
+
+	if (FDMShipPool* pPool = ShipPools.Find(ShipClass))
+	{
+		while (!pPool->Ships.IsEmpty())
+		{
+			ADMShip* pShip = pPool->Ships.Pop(EAllowShrinking::No);
+			--NumPooledShips;
+
+			// Something else may have destroyed it while it sat in the pool
+			if (IsValid(pShip))
+			{
+				pShip->ActivateShip();
+				return pShip;
+			}
+		}
+	}
+
+	// Lockstep machines spawn their own copy of every ship; don't replicate ours
+	ADMShip* pNewShip = GetWorld()->SpawnActorDeferred<ADMShip>(ShipClass, FTransform::Identity);
+	pNewShip->SetReplicates(!bLockstepTurns);
+	pNewShip->FinishSpawning(FTransform::Identity);
+
+	return pNewShip;
+}
+
+/******************************************************************************
+ * Deactivate and hide a ship (i.e. lost in combat) so a future build can
+ *		reuse it
+ * Ships are only destroyed once the pool is full
+******************************************************************************/
+void ADMGameMode::ReleaseShip(ADMShip* pShip)
+{
+	if (!IsValid(pShip) || !pShip->IsShipActive())
+	{
+		return;
+	}
+
+	if (NumPooledShips >= MaxPooledShips)
+	{
+		pShip->Destroy();
+		return;
+	}
+
+	pShip->DeactivateShip();
+	ShipPools.FindOrAdd(pShip->GetClass()).Ships.Add(pShip);
+	++NumPooledShips;
+}
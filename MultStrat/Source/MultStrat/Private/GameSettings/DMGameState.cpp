@@ -5,6 +5,7 @@
 
 #include "Commands/DMCommandQueueSubsystem.h"			// UDMCommandQueueSubsystem
 #include "Components/DMTeamComponent.h"					// UDMTeamComponent, EDMPlayerTeam
+#include "GalaxyObjects/DMGalaxyNode.h"					// LogGalaxy
 #include "GalaxyObjects/DMPlanetProcessingSubsystem.h"	// UDMPlanetProcessingSubsystem
 #include "GameFramework/PlayerState.h"					// APlayerState
 #include "GameSettings/DMGameMode.h"					// UTeamDataAsset
@@ -20,8 +21,12 @@ void ADMGameState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLife
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
 	DOREPLIFETIME(ADMGameState, CurrentTeamData);
+	DOREPLIFETIME(ADMGameState, CurrentCommandsData);
+	DOREPLIFETIME(ADMGameState, bLockstepTurns);
 	DOREPLIFETIME(ADMGameState, NextNewTeam);
 	DOREPLIFETIME(ADMGameState, bTurnProcessing);
+	DOREPLIFETIME(ADMGameState, TurnNumber);
+	DOREPLIFETIME(ADMGameState, ServerTurnHashes);
 
 }
 
@@ -105,6 +110,7 @@ void ADMGameState::CheckAllPlayersTurnsSubmitted_Implementation()
 	}
 	
 	// Execute
+	++TurnNumber;
 	UDMCommandQueueSubsystem* CommandQueue = UDMCommandQueueSubsystem::Get(this);
 	ensure(CommandQueue);
 	CommandQueue->ExecuteCommandsForTurn();
@@ -126,6 +132,139 @@ void ADMGameState::CheckAllPlayersTurnsSubmitted_Implementation()
 	bTurnProcessing = false;
 }
 
+/*/////////////////////////////////////////////////////////////////////////////
+*	Lockstep //////////////////////////////////////////////////////////////////
+*//////////////////////////////////////////////////////////////////////////////
+
+/******************************************************************************
+ * True if every machine resolves turns itself from the server's commands
+******************************************************************************/
+bool ADMGameState::IsLockstep(UObject* WorldContextObject)
+{
+	const ADMGameState* pGameState = Get(WorldContextObject);
+	return pGameState != nullptr && pGameState->bLockstepTurns;
+}
+
+/******************************************************************************
+ * Server sends the turn's validated commands, in execution order, to every
+ *		client to run locally
+ * 
+ * Client Function
+******************************************************************************/
+void ADMGameState::MulticastTurnCommands_Implementation(int32 Turn, const FCommandTurnPacket& TurnPacket)
+{
+	// The server already ran these
+	if (HasAuthority())
+	{
+		return;
+	}
+
+	UDMCommandQueueSubsystem* pCommandQueue = UDMCommandQueueSubsystem::Get(this);
+	ensure(pCommandQueue);
+	if (!IsValid(pCommandQueue))
+	{
+		return;
+	}
+
+	// May arrive before the replicated turn number does; planet processing files the turn's hash under the number it started with
+	TurnNumber = Turn;
+	pCommandQueue->ExecuteLockstepTurn(TurnPacket);
+}
+
+/*/////////////////////////////////////////////////////////////////////////////
+*	Desync Detection //////////////////////////////////////////////////////////
+*//////////////////////////////////////////////////////////////////////////////
+
+/******************************************************************************
+ * Called by planet processing once a turn has fully resolved
+ * The server publishes its hash along with the last few before it; clients
+ *		keep theirs until the server's hash for the same turn arrives. Turn
+ *		is the one that started processing; TurnNumber may already belong to
+ *		the next turn.
+ * Lockstep only. Otherwise clients never resolve a turn themselves: the
+ *		server sets and clears bTurnProcessing in the same frame, so the rep
+ *		notify that would start client processing never fires, and results
+ *		arrive actor by actor with no point at which the whole turn is known
+ *		to have replicated. A hash taken then would race replication and
+ *		report desyncs that aren't there.
+******************************************************************************/
+void ADMGameState::TurnResolved(int32 Turn, uint32 GalaxyHash)
+{
+	if (!bLockstepTurns)
+	{
+		return;
+	}
+
+	if (HasAuthority())
+	{
+		if (ServerTurnHashes.Num() >= NumServerTurnHashes)
+		{
+			ServerTurnHashes.RemoveAt(0, ServerTurnHashes.Num() - NumServerTurnHashes + 1);
+		}
+
+		FDMTurnHash& TurnHash = ServerTurnHashes.AddDefaulted_GetRef();
+		TurnHash.Turn = Turn;
+		TurnHash.Hash = GalaxyHash;
+		return;
+	}
+
+	LocalTurnHashes.Add(Turn, GalaxyHash);
+	CompareTurnHashes();
+}
+
+/******************************************************************************
+ * Compare the server's hashes against ours for the same turns, once we have
+ *		both
+******************************************************************************/
+void ADMGameState::OnRep_ServerTurnHashes()
+{
+	CompareTurnHashes();
+}
+
+/******************************************************************************
+ * Compare the server's hashes against ours for the same turns, once we have
+ *		both
+ * A local hash is only dropped once it has been compared, or once the
+ *		server's hash for its turn has left the window and it never can be.
+ *		Only the first divergent turn is reported; everything after it will
+ *		differ too.
+******************************************************************************/
+void ADMGameState::CompareTurnHashes()
+{
+	for (const FDMTurnHash& ServerTurnHash : ServerTurnHashes)
+	{
+		uint32 LocalHash = 0;
+		if (!LocalTurnHashes.RemoveAndCopyValue(ServerTurnHash.Turn, LocalHash))
+		{
+			continue;
+		}
+
+		if (LocalHash != ServerTurnHash.Hash && FirstDivergentTurn == INDEX_NONE)
+		{
+			FirstDivergentTurn = ServerTurnHash.Turn;
+			UE_LOG(LogGalaxy, Error, TEXT("Galaxy desync: turn %d resolved to %08x here, but %08x on the server"),
+				ServerTurnHash.Turn, LocalHash, ServerTurnHash.Hash)
+		}
+	}
+
+	// Only a full window can have dropped turns; anything older than it resolved too late to be checked
+	if (ServerTurnHashes.Num() < NumServerTurnHashes)
+	{
+		return;
+	}
+
+	const int32 OldestTurn = ServerTurnHashes[0].Turn;
+	for (auto It = LocalTurnHashes.CreateIterator(); It; ++It)
+	{
+		if (It.Key() < OldestTurn)
+		{
+			UE_LOG(LogGalaxy, Warning, TEXT("Galaxy hash for turn %d was never checked; the server only keeps turns %d onwards"),
+				It.Key(), OldestTurn)
+			It.RemoveCurrent();
+		}
+	}
+}
+
 /*/////////////////////////////////////////////////////////////////////////////
 *	Player Metadata Management ////////////////////////////////////////////////
 *//////////////////////////////////////////////////////////////////////////////
@@ -173,6 +312,36 @@ void ADMGameState::GetColorForTeam(EDMPlayerTeam Team, FColor& Output)
 	}
 }
 
+/******************************************************************************
+ * Check the command data asset for the default ship class; works on clients
+ *		too
+******************************************************************************/
+TSubclassOf<ADMShip> ADMGameState::GetDefaultShip() const
+{
+	if (!IsValid(CurrentCommandsData))
+	{
+		UE_LOG(LogTemp, Error, TEXT("ADMGameState::GetDefaultShip: Gamestate does not have CurrentCommandsData initialized properly!"))
+		return nullptr;
+	}
+
+	return CurrentCommandsData->DefaultShip;
+}
+
+/******************************************************************************
+ * Check the command data asset for the default ship spawn Z offset; works on
+ *		clients too
+******************************************************************************/
+float ADMGameState::GetShipSpawnZOffset() const
+{
+	if (!IsValid(CurrentCommandsData))
+	{
+		UE_LOG(LogTemp, Error, TEXT("ADMGameState::GetShipSpawnZOffset: Gamestate does not have CurrentCommandsData initialized properly!"))
+		return 0.0f;
+	}
+
+	return CurrentCommandsData->ShipSpawnZOffset;
+}
+
 /******************************************************************************
  * Checks registered players for a one who is on the given team
  * returns the player if found, nullptr otherwise
@@ -197,7 +366,8 @@ ADMPlayerState* ADMGameState::GetPlayerForTeam(EDMPlayerTeam Team)
 ******************************************************************************/
 void ADMGameState::OnRep_TurnProcessing()
 {
-	if (bTurnProcessing)
+	// Lockstep clients start processing as soon as they've run the turn's commands
+	if (bTurnProcessing || bLockstepTurns)
 	{
 		return;
 	}
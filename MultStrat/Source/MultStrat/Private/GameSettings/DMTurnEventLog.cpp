@@ -0,0 +1,171 @@
+// Copyright (c) 2025 William Pritz under MIT License
+
+
+#include "GameSettings/DMTurnEventLog.h"
+
+#include "Commands/DMCommand.h"				// UDMCommand
+#include "Commands/DMCommandQueueSubsystem.h"	// UDMCommandQueueSubsystem, LogCommands
+#include "Components/DMTeamComponent.h"			// LogTeams, EDMPlayerTeam
+#include "GalaxyObjects/DMGalaxyNode.h"			// LogGalaxy
+#include "Player/DMPlayerState.h"				// ADMPlayerState
+#include "Player/DMShip.h"						// ADMShip
+
+/*/////////////////////////////////////////////////////////////////////////////
+*	FDMTurnEvent //////////////////////////////////////////////////////////////
+*//////////////////////////////////////////////////////////////////////////////
+
+/******************************************************************************
+ * Human readable version of the event, matching our old log lines
+******************************************************************************/
+FString FDMTurnEvent::ToString() const
+{
+	const FString TeamName = StaticEnum<EDMPlayerTeam>()->GetAuthoredNameStringByIndex((int32)Team);
+
+	switch (Type)
+	{
+	case EDMTurnEventType::CommandRegistered:
+		return FString::Printf(TEXT("Command %s for player %s registered (Ship: %s, Target: %s, Priority: %d)"),
+			*Context.ToString(), *Subject.ToString(), *Ship.ToString(), *Target.ToString(), Value);
+	case EDMTurnEventType::CommandExecuted:
+		return FString::Printf(TEXT("Executing Command from player %s on team %s: %s (Ship: %s, Target: %s)"),
+			*Subject.ToString(), *TeamName, *Context.ToString(), *Ship.ToString(), *Target.ToString());
+	case EDMTurnEventType::CommandCancelled:
+		return FString::Printf(TEXT("Player %s is trying to cancel Command %s (Ship: %s, Target: %s)"),
+			*Subject.ToString(), *Context.ToString(), *Ship.ToString(), *Target.ToString());
+	case EDMTurnEventType::CommandsCancelled:
+		return Value > 0
+			? FString::Printf(TEXT("Player %s cancelled %d Commands"), *Subject.ToString(), Value)
+			: FString::Printf(TEXT("Player %s tried to cancel all their commands, but had no commands queued"), *Subject.ToString());
+	case EDMTurnEventType::ShipsBounced:
+		return FString::Printf(TEXT("Ships %s and %s both tried to traverse the connector to node %s; the ships have bounced"),
+			*Context.ToString(), *Subject.ToString(), *Target.ToString());
+	case EDMTurnEventType::CombatStarted:
+		return FString::Printf(TEXT("%s combat results (Previous Owner: %s): "), *Subject.ToString(), *TeamName);
+	case EDMTurnEventType::CombatAttacker:
+		return FString::Printf(TEXT("	Attacked by team %s with power %d"), *TeamName, Value);
+	case EDMTurnEventType::CombatSupportOnly:
+		return FString::Printf(TEXT("	Attacked by team %s with power %d, But they forgot to send an attacking ship!"), *TeamName, Value);
+	case EDMTurnEventType::CombatWinner:
+		return FString::Printf(TEXT("	The winner is %s!"), *TeamName);
+	case EDMTurnEventType::CombatNoWinner:
+		return TEXT("There is no winner!");
+	case EDMTurnEventType::TeamChanged:
+		return FString::Printf(TEXT("%s set to team %s"), *Subject.ToString(), *TeamName);
+	default:
+		return FString::Printf(TEXT("Unknown turn event %d"), (int32)Type);
+	}
+}
+
+/*/////////////////////////////////////////////////////////////////////////////
+*	FDMTurnEventLog ///////////////////////////////////////////////////////////
+*//////////////////////////////////////////////////////////////////////////////
+
+/******************************************************************************
+ * The log of the world WorldContextObject is in
+ * Each world's command queue owns its log, so a PIE server and its clients
+ *		each flush only their own events. Objects outside a game world (i.e.
+ *		class defaults) share a fallback log.
+******************************************************************************/
+FDMTurnEventLog& FDMTurnEventLog::Get(const UObject* WorldContextObject)
+{
+	UWorld* pWorld = WorldContextObject != nullptr ? WorldContextObject->GetWorld() : nullptr;
+	if (UDMCommandQueueSubsystem* pCommandQueue = UDMCommandQueueSubsystem::Get(pWorld))
+	{
+		return pCommandQueue->GetEventLog();
+	}
+
+	static FDMTurnEventLog Fallback;
+	return Fallback;
+}
+
+/******************************************************************************
+ * Record an event; objects are stored by name only
+******************************************************************************/
+void FDMTurnEventLog::Record(EDMTurnEventType Type, EDMPlayerTeam Team, const UObject* Subject, const UObject* Target, const UObject* Context, int32 Value)
+{
+	checkSlow(IsInGameThread());
+
+	if (Events.IsEmpty())
+	{
+		Events.SetNum(Capacity);
+	}
+	if (Count == Capacity)
+	{
+		Flush();
+	}
+
+	FDMTurnEvent& Event = Events[(Head + Count) % Capacity];
+	Event.Type = Type;
+	Event.Team = Team;
+	Event.Value = Value;
+	Event.Subject = Subject != nullptr ? Subject->GetFName() : NAME_None;
+	Event.Target = Target != nullptr ? Target->GetFName() : NAME_None;
+	Event.Context = Context != nullptr ? Context->GetFName() : NAME_None;
+	Event.Ship = NAME_None;
+	++Count;
+}
+
+/******************************************************************************
+ * Record a command event: its player (and their team), target node, the
+ *		command itself and the ship it acts on
+******************************************************************************/
+void FDMTurnEventLog::RecordCommand(EDMTurnEventType Type, const UDMCommand* Command, int32 Value)
+{
+	const ADMPlayerState* pPlayer = Command->GetOwningPlayer();
+	Record(Type, UDMTeamComponent::GetActorsTeam(pPlayer), pPlayer, Command->GetTargetNode(), Command, Value);
+
+	// Record always leaves the new event at the back of the buffer
+	const ADMShip* pShip = Command->GetCommandShip();
+	Events[(Head + Count - 1) % Capacity].Ship = pShip != nullptr ? pShip->GetFName() : NAME_None;
+}
+
+/******************************************************************************
+ * Hand every buffered event to the log and any bound sinks, then empty the
+ *		buffer
+******************************************************************************/
+void FDMTurnEventLog::Flush()
+{
+	checkSlow(IsInGameThread());
+
+	for (int32 i = 0; i < Count; ++i)
+	{
+		const FDMTurnEvent& Event = Events[(Head + i) % Capacity];
+		LogEvent(Event);
+		OnEventFlushed.Broadcast(Event);
+	}
+
+	Head = 0;
+	Count = 0;
+}
+
+/******************************************************************************
+ * Write the event to its log category, if that category would print it
+ * This is the only place events are formatted for the log
+******************************************************************************/
+void FDMTurnEventLog::LogEvent(const FDMTurnEvent& Event)
+{
+	switch (Event.Type)
+	{
+	case EDMTurnEventType::CommandRegistered:
+	case EDMTurnEventType::CommandExecuted:
+	case EDMTurnEventType::CommandCancelled:
+	case EDMTurnEventType::CommandsCancelled:
+		if (UE_LOG_ACTIVE(LogCommands, Display))
+		{
+			UE_LOG(LogCommands, Display, TEXT("%s"), *Event.ToString())
+		}
+		break;
+	case EDMTurnEventType::TeamChanged:
+		if (UE_LOG_ACTIVE(LogTeams, Display))
+		{
+			UE_LOG(LogTeams, Display, TEXT("%s"), *Event.ToString())
+		}
+		break;
+	default:
+		if (UE_LOG_ACTIVE(LogGalaxy, Display))
+		{
+			UE_LOG(LogGalaxy, Display, TEXT("%s"), *Event.ToString())
+		}
+		break;
+	}
+}
@@ -0,0 +1,13 @@
+// Copyright (c) 2025 William Pritz under MIT License
+
+
+#include "GameSettings/DMTurnTrace.h"
+
+UE_TRACE_CHANNEL_DEFINE(DMTurnChannel)
+
+TRACE_DECLARE_INT_COUNTER(DMTurn_CommandsRun, TEXT("DMTurn/CommandsRun"));
+TRACE_DECLARE_INT_COUNTER(DMTurn_CommandsInvalidated, TEXT("DMTurn/CommandsInvalidated"));
+TRACE_DECLARE_INT_COUNTER(DMTurn_CombatIterations, TEXT("DMTurn/CombatIterations"));
+TRACE_DECLARE_INT_COUNTER(DMTurn_Combats, TEXT("DMTurn/Combats"));
+TRACE_DECLARE_INT_COUNTER(DMTurn_Bounces, TEXT("DMTurn/Bounces"));
+TRACE_DECLARE_INT_COUNTER(DMTurn_OwnershipChanges, TEXT("DMTurn/OwnershipChanges"));
@@ -3,7 +3,7 @@
 
 #include "Player/DMBaseController.h"
 
-#include "Commands/DMCommand.h"					// UDMCommand, FCommandPacket
+#include "Commands/DMCommand.h"					// UDMCommand, FCommandPacket, FCommandTurnPacket
 #include "Commands/DMCommandQueueSubsystem.h"	// UDMCommandQueueSubsystem, LogCommands
 #include "GameSettings/DMGameState.h"			// ADMGameState
 #include "Net/UnrealNetwork.h"					// DOREPLIFETIME
@@ -58,12 +58,12 @@ bool ADMBaseController::CancelCommand(UDMCommand* pCommand)
 }
 
 /******************************************************************************
- * Queue a Command in the Command Queue Subsystem
+ * Queue a turn's worth of Commands in the Command Queue Subsystem
  * Run on the server because thats where the subsystem is
  *
  * Server Function
 ******************************************************************************/
-void ADMBaseController::QueueCommandsOnServer_Implementation(const TArray<FCommandPacket>& CommandPackets)
+void ADMBaseController::QueueCommandsOnServer_Implementation(const FCommandTurnPacket& TurnPacket)
 {
 	UDMCommandQueueSubsystem* pCommandQueue = UDMCommandQueueSubsystem::Get(this);
 
@@ -73,10 +73,8 @@ void ADMBaseController::QueueCommandsOnServer_Implementation(const TArray<FComma
 	}
 
 	// Make a copy of the command
-	for (int i = 0; i < CommandPackets.Num(); ++i)
+	for (const FCommandPacket& CommandInfo : TurnPacket.Packets)
 	{
-		const FCommandPacket& CommandInfo = CommandPackets[i];
-
 		UObject* pObjectDefault = CommandInfo.CommandClass != nullptr ? CommandInfo.CommandClass->GetDefaultObject() : nullptr;
 		UDMCommand* pCommandDefault = Cast<UDMCommand>(pObjectDefault);
 		if (pCommandDefault == nullptr)
@@ -85,9 +83,13 @@ void ADMBaseController::QueueCommandsOnServer_Implementation(const TArray<FComma
 				return;
 		}
 
-		UDMCommand* pSubmittedCommand = pCommandDefault->CopyCommand(CommandInfo);
+		UDMCommand* pSubmittedCommand = pCommandDefault->CopyCommand(CommandInfo, pCommandQueue);
 
-		pCommandQueue->RegisterCommand(pSubmittedCommand);
+		// hand rejected copies straight back to the pool
+		if (!pCommandQueue->RegisterCommand(pSubmittedCommand))
+		{
+			pCommandQueue->ReleaseCommand(pSubmittedCommand);
+		}
 	}
 
 	ProcessSubmittedTurn();
@@ -112,16 +114,14 @@ void ADMBaseController::SubmitTurn()
 	// broadcast the data to the server
 	bTurnSubmittedToServer = true;
 
-	TArray<FCommandPacket> TurnPackets;
-	int CommandCount = 0;
+	FCommandTurnPacket TurnPacket;
+	TurnPacket.Packets.Reserve(CommandsForTurn.Num());
 	for (TObjectPtr<UDMCommand> CurrCommand : CommandsForTurn)
 	{
-		TurnPackets.AddDefaulted();
-		TurnPackets[CommandCount].InitializePacket(CurrCommand);
-		++CommandCount;
+		TurnPacket.Packets.AddDefaulted_GetRef().InitializePacket(CurrCommand);
 	}
 
-	QueueCommandsOnServer(TurnPackets);
+	QueueCommandsOnServer(TurnPacket);
 }
 
 /******************************************************************************
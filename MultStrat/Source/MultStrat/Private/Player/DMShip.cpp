@@ -3,8 +3,10 @@
 
 #include "Player/DMShip.h"
 
-#include "Components/DMNodeConnectionComponent.h"	// UDMNodeConnectionComponent
+#include "Components/DMCommandFlagsComponent.h"		// UDMActiveCommandsComponent, ECommandFlags
+#include "GalaxyObjects/DMGalaxyGraphSubsystem.h"	// UDMGalaxyGraphSubsystem
 #include "GalaxyObjects/DMGalaxyNode.h"				// ADMGalaxyNode
+#include "GalaxyObjects/DMGalaxyPathfindingSubsystem.h"	// UDMGalaxyPathfindingSubsystem
 #include "Net/UnrealNetwork.h"						// DOREPLIFETIME
 
 
@@ -24,6 +26,7 @@ void ADMShip::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeP
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
 	DOREPLIFETIME(ADMShip, OwningPlayer);
+	DOREPLIFETIME(ADMShip, bShipActive);
 
 }
 
@@ -53,17 +56,79 @@ bool ADMShip::IsNodeReachable_Implementation(const ADMGalaxyNode* pTargetNode) c
 		return false;
 	}
 
+	// Binary search our current node's row of the galaxy graph
+	const UDMGalaxyGraphSubsystem* pGraph = UDMGalaxyGraphSubsystem::Get(pCurrentNode);
+	check(pGraph);
 
-	// Check all connections to our current node for a match
-	const UDMNodeConnectionComponent* pConnectComponent = pCurrentNode->GetConnectionManager();
-	check(pConnectComponent);
-	for (const ADMGalaxyNode* pCurrNode : pConnectComponent->ConnectedNodes)
+	return pGraph->AreAdjacent(pCurrentNode, pTargetNode);
+}
+
+/******************************************************************************
+ * Every node this ship could reach within MaxMoves moves, one bit per galaxy
+ *		graph index
+******************************************************************************/
+TBitArray<> ADMShip::GetReachableNodes(int32 MaxMoves) const
+{
+	UDMGalaxyPathfindingSubsystem* pPathfinding = UDMGalaxyPathfindingSubsystem::Get(GetWorld());
+	check(pPathfinding);
+
+	return pPathfinding->GetReachableNodes(GetCurrentNode(), MaxMoves, TeamComponent->GetTeam());
+}
+
+/******************************************************************************
+ * Returns true if the target node can be reached within MaxMoves movement
+ *		commands
+ * Note: Returns false if the target node is the ships current node.
+******************************************************************************/
+bool ADMShip::IsNodeReachableWithin(const ADMGalaxyNode* pTargetNode, int32 MaxMoves) const
+{
+	const UDMGalaxyGraphSubsystem* pGraph = UDMGalaxyGraphSubsystem::Get(GetWorld());
+	const int32 TargetIndex = IsValid(pGraph) ? pGraph->GetNodeIndex(pTargetNode) : INDEX_NONE;
+	if (TargetIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const TBitArray<> Reachable = GetReachableNodes(MaxMoves);
+	return Reachable.IsValidIndex(TargetIndex) && Reachable[TargetIndex];
+}
+
+/*/////////////////////////////////////////////////////////////////////////////
+*	Pooling ///////////////////////////////////////////////////////////////////
+*//////////////////////////////////////////////////////////////////////////////
+
+/******************************************************************************
+ * Bring a pooled ship back; its team and owner are set by whoever built it
+******************************************************************************/
+void ADMShip::ActivateShip()
+{
+	bShipActive = true;
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+
+	// Wake it up; the server opens a new channel and catches clients up on what changed while it slept
+	if (GetIsReplicated())
 	{
-		if (pCurrNode == pTargetNode)
-		{
-			return true;
-		}
+		SetNetDormancy(DORM_Awake);
 	}
+}
 
-	return false;
-}
\ No newline at end of file
+/******************************************************************************
+ * Undock, hide and clear the ship so it can wait in the pool
+******************************************************************************/
+void ADMShip::DeactivateShip()
+{
+	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+
+	CommandsComponent->RemoveCommandFlags(ECommandFlags::Resolved | ECommandFlags::HasShip | ECommandFlags::MovingShip);
+	OwningPlayer = nullptr;
+	bShipActive = false;
+
+	// Clients get the hidden state, then the server closes the ship's channel; clients keep their hidden copy until it wakes
+	if (GetIsReplicated())
+	{
+		SetNetDormancy(DORM_DormantAll);
+	}
+}
@@ -0,0 +1,323 @@
+// Copyright (c) 2025 William Pritz under MIT License
+
+
+#include "Misc/AutomationTest.h"						// IMPLEMENT_SIMPLE_AUTOMATION_TEST
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Async/ParallelFor.h"						// ParallelFor
+#include "Components/DMTeamComponent.h"				// EDMPlayerTeam
+#include "GalaxyObjects/DMGalaxyState.h"			// FDMGalaxyState
+#include "Math/RandomStream.h"						// FRandomStream
+
+/*
+ * Every test builds a small FDMGalaxyState by hand, resolves it and checks the
+ *		outcome the combat rules give; no world, actors or assets involved.
+ *		Ships all have power 1 unless stated otherwise.
+ */
+namespace DMGalaxyStateTest
+{
+	static constexpr EDMPlayerTeam One = EDMPlayerTeam::TeamOne;
+	static constexpr EDMPlayerTeam Two = EDMPlayerTeam::TeamTwo;
+	static constexpr EDMPlayerTeam Three = EDMPlayerTeam::TeamThree;
+
+	/** Add a planet owned by Owner with a ship of the same team docked at it; returns the ship */
+	static int32 AddPlanetWithShip(FDMGalaxyState& State, EDMPlayerTeam Owner)
+	{
+		return State.AddShip(Owner, 1, State.AddNode(Owner, true));
+	}
+
+	/** Node owner, docked ship and ship lives of two states match */
+	static void TestSameGalaxy(FAutomationTestBase& Test, const FString& What, const FDMGalaxyState& A, const FDMGalaxyState& B)
+	{
+		Test.TestTrue(What + TEXT(": node owners"), A.NodeOwner == B.NodeOwner);
+		Test.TestTrue(What + TEXT(": docked ships"), A.NodeShip == B.NodeShip);
+		Test.TestTrue(What + TEXT(": ship nodes"), A.ShipNode == B.ShipNode);
+		Test.TestTrue(What + TEXT(": live ships"), A.ShipAlive == B.ShipAlive);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDMGalaxyStateTieTest, "MultStrat.GalaxyState.Tie",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+/******************************************************************************
+ * Two teams attack the same empty planet with equal power; nobody takes it
+ *		and both ships stay home
+******************************************************************************/
+bool FDMGalaxyStateTieTest::RunTest(const FString& Parameters)
+{
+	using namespace DMGalaxyStateTest;
+
+	FDMGalaxyState State;
+	const int32 Target = State.AddNode(EDMPlayerTeam::Unowned, true);
+	const int32 ShipA = AddPlanetWithShip(State, One);
+	const int32 ShipB = AddPlanetWithShip(State, Two);
+	State.AddMove(ShipA, Target, false);
+	State.AddMove(ShipB, Target, false);
+	State.Resolve();
+
+	const FDMGalaxyState::FNodeResult& Result = State.NodeResults[Target];
+	TestEqual(TEXT("Winner"), (int32)Result.Winner, (int32)EDMPlayerTeam::Invalid);
+	TestEqual(TEXT("Margin"), State.NodeMargins[Target], 0);
+	TestEqual(TEXT("Team one power"), Result.Powers[(int32)One], 1);
+	TestEqual(TEXT("Team two power"), Result.Powers[(int32)Two], 1);
+
+	TestEqual(TEXT("Owner of the target"), (int32)State.NodeOwner[Target], (int32)EDMPlayerTeam::Unowned);
+	TestEqual(TEXT("Ship at the target"), State.NodeShip[Target], (int32)INDEX_NONE);
+	TestEqual(TEXT("Ship A stays home"), State.NodeShip[1], ShipA);
+	TestEqual(TEXT("Ship B stays home"), State.NodeShip[2], ShipB);
+	TestTrue(TEXT("Both ships live"), State.ShipAlive[ShipA] && State.ShipAlive[ShipB]);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDMGalaxyStateSupportedAttackTest, "MultStrat.GalaxyState.SupportedAttack",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+/******************************************************************************
+ * An attack with one supporting ship beats a lone defender: the defender is
+ *		destroyed, the attacker docks and the planet changes team. The
+ *		supporter never leaves home.
+******************************************************************************/
+bool FDMGalaxyStateSupportedAttackTest::RunTest(const FString& Parameters)
+{
+	using namespace DMGalaxyStateTest;
+
+	FDMGalaxyState State;
+	const int32 Attacker = AddPlanetWithShip(State, One);
+	const int32 Defender = AddPlanetWithShip(State, Two);
+	const int32 Supporter = AddPlanetWithShip(State, One);
+	State.AddMove(Attacker, 1, false);
+	State.AddMove(Supporter, 1, true);
+	State.Resolve();
+
+	const FDMGalaxyState::FNodeResult& Result = State.NodeResults[1];
+	TestEqual(TEXT("Winner"), (int32)Result.Winner, (int32)One);
+	TestEqual(TEXT("Margin"), State.NodeMargins[1], 1);
+	TestEqual(TEXT("Main attacker"), Result.Ships[(int32)One], Attacker);
+	TestEqual(TEXT("Attacking power"), Result.Powers[(int32)One], 2);
+	TestEqual(TEXT("Defending power"), Result.Powers[(int32)Two], 1);
+
+	TestFalse(TEXT("Defender destroyed"), State.ShipAlive[Defender]);
+	TestEqual(TEXT("Attacker docks at the target"), State.NodeShip[1], Attacker);
+	TestEqual(TEXT("Attacker's node"), State.ShipNode[Attacker], 1);
+	TestEqual(TEXT("Attacker's home is empty"), State.NodeShip[0], (int32)INDEX_NONE);
+	TestEqual(TEXT("Attacker's home keeps its team"), (int32)State.NodeOwner[0], (int32)One);
+	TestEqual(TEXT("Owner of the target"), (int32)State.NodeOwner[1], (int32)One);
+	TestEqual(TEXT("Supporter stays home"), State.NodeShip[2], Supporter);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDMGalaxyStateSwapTest, "MultStrat.GalaxyState.Swap",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+/******************************************************************************
+ * Two equal ships of different teams swap planets. Each node waits on the
+ *		other's ship, so the cycle is broken in node order; each ship meets
+ *		the other's home defended by its leaving ship, both combats tie and
+ *		nothing changes.
+******************************************************************************/
+bool FDMGalaxyStateSwapTest::RunTest(const FString& Parameters)
+{
+	using namespace DMGalaxyStateTest;
+
+	FDMGalaxyState State;
+	const int32 ShipA = AddPlanetWithShip(State, One);
+	const int32 ShipB = AddPlanetWithShip(State, Two);
+	State.AddMove(ShipA, 1, false);
+	State.AddMove(ShipB, 0, false);
+
+	State.BuildRegions();
+	TestEqual(TEXT("Regions"), State.Regions.Num(), 1);
+	TestFalse(TEXT("Node 0 waits on its ship"), State.CanResolve(0));
+	TestFalse(TEXT("Node 1 waits on its ship"), State.CanResolve(1));
+	State.ResolveRegion(0);
+
+	TestTrue(TEXT("Resolve order"), State.Regions[0] == TArray<int32>({ 0, 1 }));
+	TestEqual(TEXT("Winner at node 0"), (int32)State.NodeResults[0].Winner, (int32)EDMPlayerTeam::Invalid);
+	TestEqual(TEXT("Winner at node 1"), (int32)State.NodeResults[1].Winner, (int32)EDMPlayerTeam::Invalid);
+	TestEqual(TEXT("Ship A stays home"), State.NodeShip[0], ShipA);
+	TestEqual(TEXT("Ship B stays home"), State.NodeShip[1], ShipB);
+	TestEqual(TEXT("Owner of node 0"), (int32)State.NodeOwner[0], (int32)One);
+	TestEqual(TEXT("Owner of node 1"), (int32)State.NodeOwner[1], (int32)Two);
+	TestTrue(TEXT("Both ships live"), State.ShipAlive[ShipA] && State.ShipAlive[ShipB]);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDMGalaxyStateRotationTest, "MultStrat.GalaxyState.Rotation",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+/******************************************************************************
+ * Three teams rotate 0 -> 1 -> 2 -> 0, every attack supported from outside
+ *		the cycle so it beats the lone defender. The cycle is broken at node 0:
+ *		C takes it and destroys A. Node 1 was decided with A attacking, so B is
+ *		destroyed but dead A can't dock; B's own attack on node 2 goes nowhere
+ *		either, and node 2 is left empty.
+******************************************************************************/
+bool FDMGalaxyStateRotationTest::RunTest(const FString& Parameters)
+{
+	using namespace DMGalaxyStateTest;
+
+	FDMGalaxyState State;
+	const int32 ShipA = AddPlanetWithShip(State, One);
+	const int32 ShipB = AddPlanetWithShip(State, Two);
+	const int32 ShipC = AddPlanetWithShip(State, Three);
+	const int32 SupportA = AddPlanetWithShip(State, One);
+	const int32 SupportB = AddPlanetWithShip(State, Two);
+	const int32 SupportC = AddPlanetWithShip(State, Three);
+	State.AddMove(ShipA, 1, false);
+	State.AddMove(ShipB, 2, false);
+	State.AddMove(ShipC, 0, false);
+	State.AddMove(SupportA, 1, true);
+	State.AddMove(SupportB, 2, true);
+	State.AddMove(SupportC, 0, true);
+
+	State.BuildRegions();
+	TestEqual(TEXT("Regions"), State.Regions.Num(), 1);
+	State.ResolveRegion(0);
+
+	TestTrue(TEXT("Resolve order"), State.Regions[0] == TArray<int32>({ 0, 1, 2 }));
+
+	TestEqual(TEXT("Winner at node 0"), (int32)State.NodeResults[0].Winner, (int32)Three);
+	TestEqual(TEXT("C docks at node 0"), State.NodeShip[0], ShipC);
+	TestEqual(TEXT("Owner of node 0"), (int32)State.NodeOwner[0], (int32)Three);
+	TestFalse(TEXT("A destroyed"), State.ShipAlive[ShipA]);
+
+	TestEqual(TEXT("Winner at node 1"), (int32)State.NodeResults[1].Winner, (int32)One);
+	TestFalse(TEXT("B destroyed"), State.ShipAlive[ShipB]);
+	TestEqual(TEXT("Owner of node 1"), (int32)State.NodeOwner[1], (int32)Two);
+
+	// Worked out again once C left; B still counts as the attacker there
+	TestEqual(TEXT("Winner at node 2"), (int32)State.NodeResults[2].Winner, (int32)Two);
+	TestEqual(TEXT("Main attacker at node 2"), State.NodeResults[2].Ships[(int32)Two], ShipB);
+	TestEqual(TEXT("Node 2 is empty"), State.NodeShip[2], (int32)INDEX_NONE);
+	TestEqual(TEXT("Owner of node 2"), (int32)State.NodeOwner[2], (int32)Three);
+
+	TestTrue(TEXT("C lives"), State.ShipAlive[ShipC]);
+	TestTrue(TEXT("Supporters stay home"), State.NodeShip[3] == SupportA && State.NodeShip[4] == SupportB && State.NodeShip[5] == SupportC);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDMGalaxyStateChainTest, "MultStrat.GalaxyState.Chain",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+/******************************************************************************
+ * A attacks B's planet while B attacks C's; both attacks are supported, but so
+ *		is C's defence. Node 1 waits for B's combat at node 2, which B loses,
+ *		so B is still home when A's supported attack arrives and is destroyed.
+******************************************************************************/
+bool FDMGalaxyStateChainTest::RunTest(const FString& Parameters)
+{
+	using namespace DMGalaxyStateTest;
+
+	FDMGalaxyState State;
+	const int32 ShipA = AddPlanetWithShip(State, One);
+	const int32 ShipB = AddPlanetWithShip(State, Two);
+	const int32 ShipC = AddPlanetWithShip(State, Three);
+	const int32 SupportC = AddPlanetWithShip(State, Three);
+	const int32 SupportA = AddPlanetWithShip(State, One);
+	State.AddMove(ShipA, 1, false);
+	State.AddMove(ShipB, 2, false);
+	State.AddMove(SupportC, 2, true);
+	State.AddMove(SupportA, 1, true);
+
+	State.BuildRegions();
+	TestEqual(TEXT("Regions"), State.Regions.Num(), 1);
+	TestFalse(TEXT("Node 1 waits on B"), State.CanResolve(1));
+	TestTrue(TEXT("Node 2 is ready"), State.CanResolve(2));
+	State.ResolveRegion(0);
+
+	TestTrue(TEXT("Resolve order"), State.Regions[0] == TArray<int32>({ 2, 1 }));
+
+	TestEqual(TEXT("Winner at node 2"), (int32)State.NodeResults[2].Winner, (int32)Three);
+	TestEqual(TEXT("C holds node 2"), State.NodeShip[2], ShipC);
+	TestEqual(TEXT("Owner of node 2"), (int32)State.NodeOwner[2], (int32)Three);
+
+	TestEqual(TEXT("Winner at node 1"), (int32)State.NodeResults[1].Winner, (int32)One);
+	TestFalse(TEXT("B destroyed at home"), State.ShipAlive[ShipB]);
+	TestEqual(TEXT("A docks at node 1"), State.NodeShip[1], ShipA);
+	TestEqual(TEXT("Owner of node 1"), (int32)State.NodeOwner[1], (int32)One);
+	TestEqual(TEXT("A's home is empty"), State.NodeShip[0], (int32)INDEX_NONE);
+
+	TestTrue(TEXT("A and C live"), State.ShipAlive[ShipA] && State.ShipAlive[ShipC]);
+	TestTrue(TEXT("Supporters stay home"), State.NodeShip[3] == SupportC && State.NodeShip[4] == SupportA);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDMGalaxyStateParallelTest, "MultStrat.GalaxyState.ParallelMatchesSerial",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+/******************************************************************************
+ * Random galaxies resolved region by region on this thread and with every
+ *		region on its own task must come out the same, down to each node's
+ *		combat result and the resolve order
+******************************************************************************/
+bool FDMGalaxyStateParallelTest::RunTest(const FString& Parameters)
+{
+	using namespace DMGalaxyStateTest;
+
+	static constexpr int32 NumNodes = 256;
+	static constexpr int32 NumSeeds = 8;
+	static const EDMPlayerTeam Teams[] = { One, Two, Three, EDMPlayerTeam::TeamFour };
+
+	for (int32 Seed = 1; Seed <= NumSeeds; ++Seed)
+	{
+		FRandomStream Random(Seed);
+
+		FDMGalaxyState Serial;
+		for (int32 Node = 0; Node < NumNodes; ++Node)
+		{
+			const EDMPlayerTeam Owner = Random.FRand() < 0.2f ? EDMPlayerTeam::Unowned : Teams[Random.RandHelper(UE_ARRAY_COUNT(Teams))];
+			Serial.AddNode(Owner, true);
+			if (Owner != EDMPlayerTeam::Unowned)
+			{
+				Serial.AddShip(Owner, Random.RandRange(1, 3), Node);
+			}
+		}
+
+		// Short hops keep most regions small, so there are plenty of them
+		for (int32 Ship = 0; Ship < Serial.NumShips(); ++Ship)
+		{
+			if (Random.FRand() < 0.5f)
+			{
+				const int32 Target = (Serial.ShipNode[Ship] + Random.RandRange(1, 4)) % NumNodes;
+				Serial.AddMove(Ship, Target, Random.FRand() < 0.3f);
+			}
+		}
+
+		FDMGalaxyState Parallel = Serial;
+		Serial.Resolve();
+
+		Parallel.BuildRegions();
+		ParallelFor(Parallel.Regions.Num(), [&Parallel](int32 RegionIndex)
+		{
+			Parallel.ResolveRegion(RegionIndex);
+		});
+
+		const FString What = FString::Printf(TEXT("Seed %d"), Seed);
+		TestTrue(What + TEXT(": more than one region"), Serial.Regions.Num() > 1);
+		TestTrue(What + TEXT(": resolve order"), Serial.Regions == Parallel.Regions);
+		TestSameGalaxy(*this, What, Serial, Parallel);
+
+		// Only nodes with combat have a result
+		for (int32 Node = 0; Node < NumNodes; ++Node)
+		{
+			if (Serial.NodeNumPending[Node] == 0)
+			{
+				continue;
+			}
+
+			const FDMGalaxyState::FNodeResult& SerialResult = Serial.NodeResults[Node];
+			const FDMGalaxyState::FNodeResult& ParallelResult = Parallel.NodeResults[Node];
+			const bool bSame = SerialResult.Winner == ParallelResult.Winner &&
+				SerialResult.InvolvedTeams == ParallelResult.InvolvedTeams &&
+				FMemory::Memcmp(SerialResult.Ships, ParallelResult.Ships, sizeof(SerialResult.Ships)) == 0 &&
+				FMemory::Memcmp(SerialResult.Powers, ParallelResult.Powers, sizeof(SerialResult.Powers)) == 0 &&
+				Serial.NodeMargins[Node] == Parallel.NodeMargins[Node];
+			TestTrue(FString::Printf(TEXT("%s: result at node %d"), *What, Node), bSame);
+		}
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,93 @@
+// Copyright (c) 2025 William Pritz under MIT License
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "DMTurnBenchmarkCommandlet.generated.h"
+
+class ADMGalaxyNode;
+class ADMPlayerState;
+class UGameInstance;
+enum class EDMPlayerTeam : uint8;
+
+/**
+ * Headless turn processing benchmark
+ *
+ * Builds a synthetic grid galaxy of N nodes with M ships in a standalone game
+ *		world, then issues random MoveShip/BuildShip orders for K turns and
+ *		reports how long command execution and planet resolution took each turn.
+ *
+ * Usage:
+ *		MultStratServer -run=DMTurnBenchmark -nullrhi [-nodes=1024] [-ships=256]
+ *			[-turns=50] [-players=4] [-seed=1] [-movechance=0.8]
+ *			[-buildchance=0.25] [-csv=Path/To/Results.csv] [-verbose]
+ *			[-game=/Game/...GameMode_C] [-nodeclass=/Game/...Planet_C]
+ */
+UCLASS()
+class MULTSTRAT_API UDMTurnBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	/** Constructor: headless, no editor required */
+	UDMTurnBenchmarkCommandlet(const FObjectInitializer& ObjectInitializer);
+
+	//~ Begin UCommandlet Interface
+
+	/** Run the benchmark; returns 0 on success */
+	virtual int32 Main(const FString& Params) override;
+
+	//~ End UCommandlet Interface
+
+private:
+	/** Per-turn timings */
+	struct FTurnSample
+	{
+		int32 CommandsIssued = 0;
+		int32 CommandsRegistered = 0;
+		int32 ResolveTicks = 0;
+		double RegisterMs = 0.0;
+		double ExecuteMs = 0.0;
+		double ResolveMs = 0.0;
+	};
+
+	/** Spin up a standalone game world running our game mode */
+	UWorld* CreateBenchmarkWorld(const FString& GameModePath);
+
+	/** Tear down the world made by CreateBenchmarkWorld */
+	void DestroyBenchmarkWorld(UWorld* World);
+
+	/** Spawn a square-ish grid of nodes, each connected to its 4 neighbors */
+	bool BuildGalaxy(UWorld* World, UClass* NodeClass, int32 NumNodes);
+
+	/** Register the players and scatter ships over random nodes */
+	void PopulateGalaxy(UWorld* World, int32 NumPlayers, int32 NumShips);
+
+	/** Queue one turn worth of random orders; returns the # of orders issued */
+	int32 IssueRandomOrders(UWorld* World, float MoveChance, float BuildChance, int32& OutRegistered);
+
+	/** Execute the queued commands and run planet processing to completion */
+	void ProcessTurn(UWorld* World, FTurnSample& OutSample);
+
+	/** Write per-turn samples to disk */
+	void WriteCsv(const FString& CsvPath, const TArray<FTurnSample>& Samples) const;
+
+	UPROPERTY()
+	TObjectPtr<UGameInstance> GameInstance;
+
+	UPROPERTY()
+	TArray<TObjectPtr<ADMGalaxyNode>> Nodes;
+
+	UPROPERTY()
+	TArray<TObjectPtr<ADMPlayerState>> Players;
+
+	/** Player issuing orders for each team */
+	TMap<EDMPlayerTeam, ADMPlayerState*> TeamPlayers;
+
+	/** Drives every random choice so runs with the same seed are repeatable */
+	FRandomStream Random;
+
+	/** Guard against a galaxy that never finishes resolving */
+	static constexpr int32 MaxResolveTicks = 100000;
+};
@@ -8,6 +8,8 @@
 
 class ADMGalaxyNode;
 class ADMPlayerState;
+class ADMShip;
+class UDMCommandQueueSubsystem;
 enum class ECommandFlags : uint8;
 
 /**
@@ -39,6 +41,20 @@ public:
 	ADMGalaxyNode* pTarget = nullptr;
 };
 
+/**
+ * Native counterpart to UDMCommandInit
+ * Plain data so C++ callers (AI, bulk order tools) can build commands without
+ *		allocating a UObject just to carry the initialization variables
+ */
+struct FDMCommandParams
+{
+	/** Player requesting the command */
+	ADMPlayerState* RequestingPlayer = nullptr;
+
+	/** Target node of the command */
+	ADMGalaxyNode* Target = nullptr;
+};
+
 /**
  * Parent Class of all commands players used to change the current gamestate
  * Run only by Command Queue Subsystem.
@@ -77,6 +93,25 @@ public:
 	void CommandUnqueued();
 	virtual void CommandUnqueued_Implementation() {}
 
+	/**
+	 * Clear everything set by initialization so the command queue can reuse this object
+	 * Children with their own data should clear it too
+	 */
+	virtual void ResetCommand();
+
+	/**
+	 * Do the order independent part of RunCommand now, while other players are still submitting,
+	 *		so RunCommand only has to resolve conflicts when the turn executes.
+	 * Presumed to only be called by CommandQueueSubsystem when the command is registered
+	 */
+	void PreStage();
+
+	/** Undo anything PreStage did; called when a registered command is cancelled or invalidated */
+	void RollbackPreStage();
+
+	/** Whether PreStage did work that RunCommand can skip */
+	bool IsPreStaged() const								{ return bPreStaged; }
+
 	//~=============================================================================
 	// Command Management Functions
 
@@ -88,6 +123,12 @@ public:
 	bool InitializeCommand(UDMCommandInit* InitVariables);
 	virtual bool InitializeCommand_Implementation(UDMCommandInit* InitVariables);
 
+	/**
+	 * Native initialization from plain data; InitializeCommand unpacks its init object into this
+	 * returns true if the input is valid
+	 */
+	bool InitializeFromParams(const FDMCommandParams& Params);
+
 	/**
 	 * Overrideable IsValid method; makes sure the command can still execute in the current gamestate
 	 * returns true if command can be run successfully
@@ -102,12 +143,12 @@ public:
 	virtual FString CommandDebug_Implementation() const		{ return FString::Printf(TEXT("No Debug for class %s"), *GetClass()->GetFName().ToString()); }
 
 	/**
-	 * Create a new UObject of this command's class type and copy the data from command data into it
+	 * Get a UObject of this command's class type from the command pool and copy the data from command data into it
 	 * Used when sending commands from the client to the server instead of replication so that we
 	 *		don't have to wait for unreal's automatic replication to copy the data over for us;
 	 *		not all clients need a copy of the command, just the server.
 	 */
-	virtual UDMCommand* CopyCommand(const struct FCommandPacket& Packet);
+	virtual UDMCommand* CopyCommand(const struct FCommandPacket& Packet, UDMCommandQueueSubsystem* CommandPool) const;
 
 	/**
 	 * Fill data for future use of CopyCommand calls
@@ -120,15 +161,33 @@ public:
 	UFUNCTION(BlueprintCallable)
 	const ADMPlayerState* GetOwningPlayer() const			{ return pOwningPlayer; }
 
+	UFUNCTION(BlueprintCallable)
+	ADMGalaxyNode* GetTargetNode() const					{ return pTargetNode; }
+
 	UFUNCTION(BlueprintCallable)
 	ECommandFlags GetCommandFlags() const					{ return CommandFlags;}
 
+	/** Ship the command acts on, if it has one; used by the turn event log */
+	virtual const ADMShip* GetCommandShip() const			{ return nullptr; }
+
 	/** higher priority commands run first.Set when registered to the command queue */
 	uint8 Priority = 0;
 
+	/** Index of this command inside its priority bucket in the command queue; INDEX_NONE when not registered */
+	int32 QueueSlot = INDEX_NONE;
+
 protected:
 	virtual void GetCopyCommandData(const TArray<TObjectPtr<UObject>>& CommandData);
 
+	/**
+	 * Order independent work that can happen before the turn executes (i.e telling a node a ship is coming)
+	 * returns true if anything was staged; UndoPreStageCommand must then be able to undo it
+	 */
+	virtual bool PreStageCommand()							{ return false; }
+
+	/** Undo everything PreStageCommand did */
+	virtual void UndoPreStageCommand()						{}
+
 	/** 
 	 * Commands can set these flags on target objects/homebased objects when registered
 	 */
@@ -142,6 +201,10 @@ protected:
 	/** Galaxy node the command wants to interact with(i.e, spawning on a node, moving to a node) */
 	UPROPERTY(BlueprintReadOnly, meta = (DisplayName = "Target Node"))
 	TObjectPtr<ADMGalaxyNode> pTargetNode;
+
+private:
+	/** Set when PreStageCommand did work at registration */
+	bool bPreStaged = false;
 };
 
 USTRUCT()
@@ -160,3 +223,36 @@ struct MULTSTRAT_API FCommandPacket
 	UPROPERTY()
 	TArray<TObjectPtr<UObject>> Data;
 };
+
+/**
+ * Every command a player submits for a turn, sent to the server in one RPC
+ * 
+ * NetSerialize writes each command class and each referenced object once into a table
+ *		(classes and objects go through the package map, so they're sent as NetGUIDs),
+ *		and each packet only writes bit-packed indices into those tables.
+ *		A turn full of orders from the same player on the same handful of planets stays tiny.
+ */
+USTRUCT()
+struct MULTSTRAT_API FCommandTurnPacket
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Custom replication; see struct comment */
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	UPROPERTY()
+	TArray<FCommandPacket> Packets;
+
+	/** Upper limits on incoming data so a bad packet can't make the server allocate forever */
+	static constexpr uint32 MaxPackets = 4096;
+	static constexpr uint32 MaxDataPerPacket = 16;
+};
+
+template<>
+struct TStructOpsTypeTraits<FCommandTurnPacket> : public TStructOpsTypeTraitsBase2<FCommandTurnPacket>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
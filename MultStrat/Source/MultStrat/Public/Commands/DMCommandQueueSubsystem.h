@@ -4,16 +4,32 @@
 
 #include "CoreMinimal.h"
 #include "Subsystems/WorldSubsystem.h"
+#include "GameSettings/DMTurnEventLog.h"
 #include "DMCommandQueueSubsystem.generated.h"
 
 class ADMPlayerState;
 class UDMCommand;
+struct FCommandTurnPacket;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogCommands, Log, All);
 
 /**
- * Subsystem that only lives on the server (for now; may change for prediction system?)
+ * All registered commands sharing a single priority value
+ * Wrapped in a struct so the buckets can be a UPROPERTY (stops garbage collection)
+ */
+USTRUCT()
+struct MULTSTRAT_API FDMCommandBucket
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<TObjectPtr<UDMCommand>> Commands;
+};
+
+/**
  * Receives, tracks, cancels, and processes player commands for turn
+ * Players only register commands on the server; clients only have this subsystem
+ *		to run the server's commands themselves in lockstep (see ADMGameMode::bLockstepTurns)
  */
 UCLASS()
 class MULTSTRAT_API UDMCommandQueueSubsystem : public UWorldSubsystem
@@ -26,10 +42,16 @@ public:
 
 	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
 
+	/** Hand anything still buffered to the log before the world goes away */
+	virtual void Deinitialize() override;
+
 	//~ End UWorldSubsystem Interface
 
 	static UDMCommandQueueSubsystem* Get(UObject* WorldContextObject);
 
+	/** This world's turn event log; see FDMTurnEventLog::Get */
+	FDMTurnEventLog& GetEventLog()							{ return EventLog; }
+
 	//~=============================================================================
 	// Command Processing Functions
 	
@@ -37,8 +59,11 @@ public:
 	 * Executes all commands for the turn, in priority order. Any orders submitted
 	 * after this is executed will be queued for the next turn.
 	 * 
+	 * Every command is validated up front (in parallel where possible) against the
+	 * galaxy before any command runs; only commands that pass are run.
+	 * 
 	 * Any objects that want to solidify their gamestate for a turn
-	 * (i.e ADMGalaxyNode::ResolveTurn) should rely on a turn being marked processed
+	 * (i.e ADMGalaxyNode::ApplyTurnResult) should rely on a turn being marked processed
 	 * by this command
 	 * 
 	 * DMTODO: Keep track of the current turn # in game state
@@ -46,6 +71,12 @@ public:
 	UFUNCTION(BlueprintCallable, meta = (DevelopmentOnly, ToolTip = "Executes all the commands for turn. Should only be executed in C++ when all players are marked as turn submitted."))
 	void ExecuteCommandsForTurn();
 
+	/**
+	 * Lockstep clients: run the commands the server ran this turn, in the same order, then resolve planets locally
+	 * Any planet processing left over from the last turn is finished first so both turns resolve in order
+	 */
+	void ExecuteLockstepTurn(const FCommandTurnPacket& TurnPacket);
+
 	/**
 	 * Registers a command with the subsystem.
 	 * Returns the command ID to be stored if a command is requested to be cancelled
@@ -61,8 +92,55 @@ public:
 	void CancelCommands(const ADMPlayerState* Player);
 	void CancelCommands_Implementation(const ADMPlayerState* Player);
 
+	//~=============================================================================
+	// Command Pooling
+
+	/**
+	 * Get a command of the given class to fill with data; reuses a pooled command when one is available
+	 * Commands from the pool are owned by this subsystem and are returned to the pool once they run or are cancelled
+	 */
+	UDMCommand* AcquireCommand(TSubclassOf<UDMCommand> CommandClass);
+
+	/**
+	 * Reset a command and return it to the pool for a future turn
+	 * Commands not created by AcquireCommand are ignored and left for garbage collection
+	 */
+	void ReleaseCommand(UDMCommand* Command);
+
 private:
-	/** Array of all active commands */
+	/**
+	 * Run Validate on every command before any of them execute
+	 * Commands validated natively run in parallel; OutValid[i] is true if Commands[i] can be run
+	 */
+	void ValidateCommands(const TArray<UDMCommand*>& Commands, TArray<bool>& OutValid) const;
+
+	/** Validate, then run the turn's commands in order, return them to the pool and start planet processing */
+	void RunTurnCommands(const TArray<UDMCommand*>& TurnCommands);
+
+	/** Smallest number of commands handed to a single validation task */
+	static constexpr int32 ValidationBatchSize = 32;
+
+	/** One bucket for every possible value of UDMCommand::Priority */
+	static constexpr int32 NumPriorityBuckets = 256;
+
+	/**
+	 * All active commands, bucketed by priority when registered so that
+	 * executing a turn is a walk over the buckets instead of a sort
+	 */
 	UPROPERTY()
-	TArray<TObjectPtr<UDMCommand>> ActiveCommands;
+	FDMCommandBucket PriorityBuckets[NumPriorityBuckets];
+
+	/**
+	 * Every command registered by a player this turn, so cancelling only touches that player's commands.
+	 * Cancelled commands leave a nullptr in their bucket slot instead of shifting the bucket.
+	 * Not a UPROPERTY; the commands are kept alive by PriorityBuckets and players are only used as keys.
+	 */
+	TMap<const ADMPlayerState*, TArray<UDMCommand*>> PlayerCommands;
+
+	/** Reset commands waiting to be reused, per command class */
+	UPROPERTY()
+	TMap<TObjectPtr<UClass>, FDMCommandBucket> CommandPools;
+
+	/** Turn events recorded by anything in this world */
+	FDMTurnEventLog EventLog;
 };
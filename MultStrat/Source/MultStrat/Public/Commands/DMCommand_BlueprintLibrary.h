@@ -12,6 +12,8 @@ class ADMPlanet;
 class ADMPlayerState;
 class UDMCommand_BuildShip;
 class UDMCommand_MoveShip;
+struct FDMCommandParams;
+struct FDMMoveShipParams;
 
 /**
  * Blueprint library to test if commands are possible (for UI) and to build command objects (for blueprints)
@@ -47,5 +49,18 @@ class MULTSTRAT_API UDMCommand_BlueprintLibrary : public UBlueprintFunctionLibra
 
 	UFUNCTION(BlueprintCallable)
 	static UDMCommand_MoveShip* MakeCommand_MoveShip(ADMPlayerState* RequestingPlayer, ADMShip* Ship, ADMGalaxyNode* PlanetToBuild);
-	
+
+public:
+	//~=============================================================================
+	// Native Construction
+	// The Blueprint functions above are thin wrappers around these. C++ callers
+	// issuing many orders (AI, bulk order tools) should use these directly; no
+	// UObjects are made for the init data, and failures are reported in
+	// OutFailString instead of the log.
+
+	/** Build the BuildShip command; returns nullptr and fills OutFailString (if given) on failure */
+	static UDMCommand_BuildShip* BuildCommand_BuildShip(const FDMCommandParams& Params, FString* OutFailString = nullptr);
+
+	/** Build the MoveShip command; returns nullptr and fills OutFailString (if given) on failure */
+	static UDMCommand_MoveShip* BuildCommand_MoveShip(const FDMMoveShipParams& Params, FString* OutFailString = nullptr);
 };
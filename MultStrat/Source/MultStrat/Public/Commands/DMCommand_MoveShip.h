@@ -25,6 +25,15 @@ public:
 	ADMShip* pShip = nullptr;
 };
 
+/**
+ * Native counterpart to UDMCommandInitMoveShip; see FDMCommandParams
+ */
+struct FDMMoveShipParams : public FDMCommandParams
+{
+	/** Ship to be moved */
+	ADMShip* Ship = nullptr;
+};
+
 /**
  * Command to move a ship to a target planet (may not be adjacent in the future?)
  */
@@ -56,6 +65,12 @@ public:
 	 */
 	virtual bool InitializeCommand_Implementation(UDMCommandInit* InitVariables) override;
 
+	/**
+	 * Native initialization from plain data; InitializeCommand unpacks its init object into this
+	 * returns whether init was successful
+	 */
+	bool InitializeMoveShip(const FDMMoveShipParams& Params);
+
 	/**
 	 * Makes sure our ship still exists
 	 * returns true if command can be run successfully
@@ -65,17 +80,26 @@ public:
 	/** returns a string with the name of the command, what it does, and what it will operate on */
 	virtual FString CommandDebug_Implementation() const override;
 
-	/** create a new moveship command object based on input data */
-	virtual UDMCommand* CopyCommand(const struct FCommandPacket& Packet) override;
-	
+	/** Clear our ship along with the base command data so the command can be pooled */
+	virtual void ResetCommand() override;
+
 	/** Fill data for future use of CopyCommand calls */
 	virtual void FillCopyCommandData(TArray<TObjectPtr<UObject>> &CommandData) override;
 
+	/** The ship we're moving */
+	virtual const ADMShip* GetCommandShip() const override		{ return pShip; }
+
 protected:
 
 	/** Get data for CopyCommand calls */
 	virtual void GetCopyCommandData(const TArray<TObjectPtr<UObject>>& CommandData) override;
 
+	/** Tell the target node our ship is coming and mark the ship as moving */
+	virtual bool PreStageCommand() override;
+
+	/** Take our ship back out of the target's pending ships */
+	virtual void UndoPreStageCommand() override;
+
 	//~ End UDMCommand Interface
 
 
@@ -23,14 +23,6 @@ class MULTSTRAT_API ADMConnector : public ASplineMeshActor
 public:
 	UFUNCTION(BlueprintImplementableEvent, meta = (ForceAsFunction))
 	void InitializeSplineMesh(const ADMGalaxyNode* StartingNode, const ADMGalaxyNode* EndingNode);
-
-	void SetTraversingShip(ADMShip* NewShip)	{ TraversingShip = NewShip; }
-	ADMShip* GetTraversingShip()				{ return TraversingShip; }
-
-protected:
-	/** Used while commands are running to check for "bounce" situations where 2 ships use the same connector */
-	UPROPERTY()
-	TObjectPtr<ADMShip> TraversingShip;
 };
 
 /**
@@ -50,32 +42,29 @@ public:
 
 	//~ Begin UActorComponent Interface
 
-	/** On BeginPlay, Construct or find our connectors */
+	/** On BeginPlay, make sure we're on a node; connectors are spawned by UDMGalaxyGraphSubsystem */
 	virtual void BeginPlay() override;
 
 	//~ End UActorComponent Interface
 
 	/**
-	 * Reserve a connector from this planet to another planet
-	 * Returns true if the spot is reserved; returns false if the connector is in use, or if the connection DNE
-	 * If this function is called while another ship has reserved the conector, we will "bounce" that ship's movement
+	 * Reserve the edge from this planet to another planet in UDMGalaxyGraphSubsystem
+	 * Returns true if the spot is reserved; returns false if the edge is in use, or if the connection DNE
+	 * If this function is called while another ship has reserved the edge, we will "bounce" that ship's movement
 	 */
 	bool ReserveShipTraversal(ADMGalaxyNode* TargetNode, ADMShip* ReservingShip);
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Replicated)
 	TArray<const ADMGalaxyNode*> ConnectedNodes;
 
+	/** Connector drawn along edges to this node's connections */
+	TSubclassOf<ADMConnector> GetConnectorClass() const		{ return ConnectorClass; }
+
 protected:
 
 	UPROPERTY(BlueprintReadWrite, EditDefaultsOnly)
 	TSubclassOf<ADMConnector> ConnectorClass;
 
-	/**
-	 * Find the associated connector for the planet; should be at the same index
-	 * in the ConnectorSplines array as the planet is in our ConnectedNodes array
-	 */
+	/** Find the connector on the edge between our node and the given one */
 	ADMConnector* GetConnectorForNode(const ADMGalaxyNode* Planet);
-
-	/** Array of connector splines; each connector is at the same index of its related planet in ConnectedNodes */
-	TArray<ADMConnector*> ConnectorSplines;
 };
\ No newline at end of file
@@ -38,6 +38,9 @@ public:
 	/** Replication */
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
+	/** Galaxy objects' teams come out of turn resolution, which lockstep machines do themselves; stop replicating them */
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
 	//~=============================================================================
 	// Team Testing
 
@@ -0,0 +1,146 @@
+// Copyright (c) 2025 William Pritz under MIT License
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DMGalaxyGraphSubsystem.generated.h"
+
+class ADMConnector;
+class ADMGalaxyNode;
+class ADMShip;
+
+/**
+ * Galaxy wide adjacency, built once when the world begins play
+ *
+ * Every node gets a dense graph index (ADMGalaxyNode::GetGraphIndex), and each
+ *		node's connections are stored in compressed sparse row form: one flat
+ *		array of neighbor indices, sorted per node, with a matching array of
+ *		edge ids. "Is A next to B" and "which edge joins A and B" are a binary
+ *		search over A's neighbors instead of a scan of its connection component.
+ *
+ * Node order is sorted by name so indices and edge ids match on every machine.
+ * An edge is one unordered pair of nodes, shared by both directions; adjacency
+ *		itself follows each node's own ConnectedNodes list.
+ *
+ * Each edge also owns the one ADMConnector drawn along it, spawned in a single
+ *		pass over the edges when the graph is built, and this turn's ship
+ *		reservation (see ReserveEdge).
+ *
+ * Nodes or connections added after begin play aren't picked up until RebuildGraph.
+ */
+UCLASS()
+class MULTSTRAT_API UDMGalaxyGraphSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Static Gettor */
+	static UDMGalaxyGraphSubsystem* Get(UObject* WorldContextObject);
+
+	//~ Begin UWorldSubsystem Interface
+
+	/** Build the graph before any actor begins play */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	//~ End UWorldSubsystem Interface
+
+	/** Index every node in the world, rebuild the adjacency from their connection components and respawn the connectors */
+	void RebuildGraph();
+
+	/** Bumped every time the graph is rebuilt; anything cached from the graph is stale once this changes */
+	uint32 GetGeneration() const										{ return Generation; }
+
+	/** Bumped whenever a node's ship or owner changes; routes that avoid occupied nodes are stale once this changes */
+	uint32 GetBlockingGeneration() const								{ return BlockingGeneration; }
+
+	/** Called by nodes when their ship or owner changes */
+	void MarkBlockingStateChanged()										{ ++BlockingGeneration; }
+
+	//~=============================================================================
+	// Nodes
+
+	int32 GetNumNodes() const											{ return Nodes.Num(); }
+
+	ADMGalaxyNode* GetNode(int32 NodeIndex) const						{ return Nodes.IsValidIndex(NodeIndex) ? Nodes[NodeIndex].Get() : nullptr; }
+
+	/** Graph index of the node, INDEX_NONE if it isn't part of the graph */
+	int32 GetNodeIndex(const ADMGalaxyNode* Node) const;
+
+	/** Sorted graph indices of every node NodeIndex connects to */
+	TConstArrayView<int32> GetNeighbors(int32 NodeIndex) const;
+
+	/** Edge ids matching GetNeighbors, entry for entry */
+	TConstArrayView<int32> GetNeighborEdges(int32 NodeIndex) const;
+
+	//~=============================================================================
+	// Edges
+
+	int32 GetNumEdges() const											{ return EdgeStart.Num(); }
+
+	/** Graph indices of the nodes at each end of an edge; the start always has the lower index */
+	int32 GetEdgeStart(int32 EdgeId) const								{ return EdgeStart[EdgeId]; }
+	int32 GetEdgeEnd(int32 EdgeId) const								{ return EdgeEnd[EdgeId]; }
+
+	/** Position of To in GetNeighbors(From); INDEX_NONE if From doesn't connect to To */
+	int32 FindNeighborIndex(int32 From, int32 To) const;
+
+	/** True if From lists To as a connection */
+	bool AreAdjacent(int32 From, int32 To) const						{ return FindNeighborIndex(From, To) != INDEX_NONE; }
+	bool AreAdjacent(const ADMGalaxyNode* From, const ADMGalaxyNode* To) const;
+
+	/** Id of the edge From uses to reach To; INDEX_NONE if From doesn't connect to To */
+	int32 FindEdge(int32 From, int32 To) const;
+	int32 FindEdge(const ADMGalaxyNode* From, const ADMGalaxyNode* To) const;
+
+	/** Connector drawn along the edge; nullptr for an invalid edge or if neither end has a connector class */
+	ADMConnector* GetEdgeConnector(int32 EdgeId) const					{ return EdgeConnectors.IsValidIndex(EdgeId) ? EdgeConnectors[EdgeId].Get() : nullptr; }
+
+	//~=============================================================================
+	// Edge Reservations
+
+	/**
+	 * Claim an edge for a ship moving along it this turn
+	 * returns the ship that already holds the edge, or nullptr if the edge was free and now belongs to Ship.
+	 * Both directions share an edge, so two ships swapping nodes (A to B and B to A) collide here.
+	 */
+	ADMShip* ReserveEdge(int32 EdgeId, ADMShip* Ship);
+
+	/** Ship holding the edge this turn, nullptr if it's free */
+	ADMShip* GetEdgeReservation(int32 EdgeId) const;
+
+	/** Free every edge for the next turn; reservations are stamped with the turn they were made in, so this is O(1) */
+	void ClearEdgeReservations()										{ ++ReservationTurn; }
+
+private:
+	/** Spawn one connector per edge, destroying any left from a previous build */
+	void SpawnConnectors();
+
+	/** Every node, by graph index */
+	UPROPERTY()
+	TArray<TObjectPtr<ADMGalaxyNode>> Nodes;
+
+	/** Node i's neighbors are Neighbors[NeighborOffsets[i]] to Neighbors[NeighborOffsets[i + 1] - 1] */
+	TArray<int32> NeighborOffsets;
+	TArray<int32> Neighbors;
+	TArray<int32> NeighborEdges;
+
+	/** Nodes at each end of every edge, by edge id */
+	TArray<int32> EdgeStart;
+	TArray<int32> EdgeEnd;
+
+	/** Connector on each edge, by edge id */
+	UPROPERTY()
+	TArray<TObjectPtr<ADMConnector>> EdgeConnectors;
+
+	/** Ship holding each edge, by edge id; only counts while EdgeReservationTurns matches ReservationTurn */
+	UPROPERTY()
+	TArray<TObjectPtr<ADMShip>> EdgeReservations;
+	TArray<uint32> EdgeReservationTurns;
+
+	/** Starts at 1 so freshly zeroed stamps are already stale */
+	uint32 ReservationTurn = 1;
+
+	uint32 Generation = 0;
+	uint32 BlockingGeneration = 0;
+};
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Components/DMTeamComponent.h"
 #include "GalaxyObjects/DMBaseGalaxyObject.h"
 #include "DMGalaxyNode.generated.h"
 
@@ -10,10 +11,29 @@ class ADMGalaxyNode;
 class ADMShip;
 class UDMCommand;
 class UDMNodeConnectionComponent;
-enum class EDMPlayerTeam : uint8;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogGalaxy, Log, All);
 
+/**
+ * Power every team brought to a node this turn, as worked out by FDMGalaxyState
+ * One slot per team, so it lives on the stack; nothing is allocated per node
+ */
+struct FDMTeamPowers
+{
+	static constexpr int32 NumTeams = (int32)EDMPlayerTeam::Count;
+
+	/** Main attacking ship per team; nullptr if the team is only supporting */
+	ADMShip* Ships[NumTeams] = {};
+
+	/** Total power of each team's fleet */
+	size_t Powers[NumTeams] = {};
+
+	/** One bit per team that has any ship involved */
+	uint32 InvolvedTeams = 0;
+
+	bool IsInvolved(EDMPlayerTeam Team) const		{ return (InvolvedTeams & (1u << (uint32)Team)) != 0; }
+};
+
 /**
  * Galaxy Nodes make up the map of all ndoes players can interact with
  */
@@ -29,17 +49,23 @@ public:
 	/** Replication */
 	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
+	/** Lockstep machines resolve ships themselves; stop replicating them */
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+	/** Start contributing to the galaxy hash */
+	virtual void BeginPlay() override;
+
+	/** Stop contributing to the galaxy hash */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	//~=============================================================================
 	// Command Functions
 
-	/** 
-	 * Check all pending ships and see if the math works out where no matter what happens
-	 * in other combats, this node can safely resolve 
+	/**
+	 * Apply this turn's combat result, worked out by FDMGalaxyState; the loser is pooled and the winner takes the node
+	 * Powers must match this node's pending ships, see UDMPlanetProcessingSubsystem::ProcessPlanetCombat
 	 */
-	bool CanResolveTurn();
-
-	/** Resolve all pending ships after all the commands have executed for a turn */
-	void ResolveTurn();
+	void ApplyTurnResult(const FDMTeamPowers& Powers, EDMPlayerTeam WinningTeam);
 
 	/** 
 	 * Used to remove the current ship
@@ -77,8 +103,15 @@ public:
 	UFUNCTION(BlueprintCallable)
 	ADMShip* GetShip() const										{ return CurrentShip; }
 
+	bool HasPendingShips() const									{ return !PendingShips.IsEmpty(); }
+
+	const TMap<TObjectPtr<ADMShip>, bool>& GetPendingShips() const	{ return PendingShips; }
+
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	UDMNodeConnectionComponent* GetConnectionManager() const		{ return ConnectionManagerComponent; }
+
+	/** Dense index of this node in UDMGalaxyGraphSubsystem; INDEX_NONE until the graph is built */
+	int32 GetGraphIndex() const										{ return GraphIndex; }
 	
 protected:
 
@@ -88,8 +121,16 @@ protected:
 	 */
 	virtual void SetCurrentShip(ADMShip* NewShip);
 
-	/** Calculate the power of all factions attack this node */
-	virtual void GetPendingPowers(TMap<EDMPlayerTeam, TPair<ADMShip*, size_t>>& Powers);
+	/** Owner, ship team or ship power may have changed; swap this node's old state hash in the galaxy hash for the new one */
+	void UpdateStateHash();
+
+	/** Keep the galaxy hash in step with team changes, including replicated ones */
+	UFUNCTION()
+	void OnTeamChanged(AActor* ChangedActor, EDMPlayerTeam NewTeam);
+
+	/** Keep the galaxy hash in step with the replicated ship */
+	UFUNCTION()
+	void OnRep_CurrentShip();
 
 	/** 
 	 * Current ship docked at this node
@@ -98,7 +139,7 @@ protected:
 	 * any changes to ships (i.e changing their color, shape, etc) should be done
 	 * INSIDE the ship's class, either via code or blueprints!
 	 */
-	UPROPERTY(Replicated)
+	UPROPERTY(Replicated, ReplicatedUsing = OnRep_CurrentShip)
 	TObjectPtr<ADMShip> CurrentShip = nullptr;
 
 	/** Compartmentalized management of connected nodes */
@@ -108,4 +149,15 @@ protected:
 	/** Ships trying to move to this node this turn */
 	UPROPERTY()
 	TMap<TObjectPtr<ADMShip>, bool> PendingShips;
+
+private:
+	/** CRC of the node's name; names match on every machine, pointers and FName indices don't */
+	uint32 NameHash = 0;
+
+	/** This node's current share of the galaxy hash; 0 when not in play */
+	uint32 StateHash = 0;
+
+	/** Only the graph hands out graph indices */
+	friend class UDMGalaxyGraphSubsystem;
+	int32 GraphIndex = INDEX_NONE;
 };
@@ -0,0 +1,125 @@
+// Copyright (c) 2025 William Pritz under MIT License
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DMGalaxyPathfindingSubsystem.generated.h"
+
+class ADMGalaxyNode;
+class UDMGalaxyGraphSubsystem;
+enum class EDMPlayerTeam : uint8;
+
+/** One route question for UDMGalaxyPathfindingSubsystem::GetDistances */
+struct FDMPathQuery
+{
+	const ADMGalaxyNode* From = nullptr;
+	const ADMGalaxyNode* To = nullptr;
+};
+
+/**
+ * Multi hop route questions over UDMGalaxyGraphSubsystem: how many moves from A
+ *		to B, and which nodes to move through
+ *
+ * Distances are in hops (one move command each). Single questions, distance
+ *		or route, use A* with a straight line heuristic. Batched questions and
+ *		GetDistancesFrom run one BFS per distinct start node, spread over
+ *		worker threads. Galaxies of up to AllPairsMaxNodes nodes instead get an
+ *		all pairs distance table, built by the first distance or route
+ *		question, after which every distance is a lookup and every route a
+ *		walk down the table. Reachability questions never build it.
+ *
+ * Reachability sets (every node within K moves) are cached per start node, K
+ *		and team until the graph is rebuilt or some node's ship or owner changes.
+ *
+ * Cached data is thrown away whenever the graph is rebuilt. Game thread only.
+ */
+UCLASS(Config = Game)
+class MULTSTRAT_API UDMGalaxyPathfindingSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Static Gettor */
+	static UDMGalaxyPathfindingSubsystem* Get(UObject* WorldContextObject);
+
+	/**
+	 * Fewest moves it takes to get from one node to another; 0 for the same node
+	 * returns INDEX_NONE if To can't be reached from From
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	int32 GetDistance(const ADMGalaxyNode* From, const ADMGalaxyNode* To);
+
+	/**
+	 * Shortest route from one node to another, both ends included
+	 * returns false (and an empty route) if To can't be reached from From
+	 */
+	UFUNCTION(BlueprintCallable)
+	bool FindPath(const ADMGalaxyNode* From, const ADMGalaxyNode* To, TArray<ADMGalaxyNode*>& OutPath);
+
+	/** GetDistance for many questions at once; OutDistances[i] answers Queries[i] */
+	void GetDistances(TConstArrayView<FDMPathQuery> Queries, TArray<int32>& OutDistances);
+
+	/** Distance from one node to every node in the graph, by graph index; INDEX_NONE where unreachable */
+	void GetDistancesFrom(const ADMGalaxyNode* From, TArray<int32>& OutDistances);
+
+	/** True once the all pairs table has been built for the current graph */
+	bool HasAllPairsTable() const						{ return !AllPairs.IsEmpty(); }
+
+	/**
+	 * Every node a ship of the given team could reach within MaxMoves moves, one bit per graph index
+	 * Routes can end at a node holding another team's ship but can't go through it; that ship has to be beaten first.
+	 * The start node itself is never set. Cached until the graph or any node's ship or owner changes.
+	 * Returns a copy; the cache may rehash or reset on the next call. One bit per node, so copying is cheap.
+	 */
+	TBitArray<> GetReachableNodes(const ADMGalaxyNode* From, int32 MaxMoves, EDMPlayerTeam Team);
+
+protected:
+	/** Galaxies with at most this many nodes get an all pairs distance table (2 bytes per pair); clamped to AllPairsNodeLimit */
+	UPROPERTY(Config)
+	int32 AllPairsMaxNodes = 2048;
+
+	/** Largest galaxy whose table can still be indexed with int32; the square root of MAX_int32 */
+	static constexpr int32 AllPairsNodeLimit = 46340;
+
+	/** Smallest number of start nodes handed to a single BFS task */
+	static constexpr int32 BatchSize = 8;
+
+	/** Marks unreachable pairs in the all pairs table */
+	static constexpr uint16 UnreachableDistance = MAX_uint16;
+
+private:
+	/** Throw away anything cached from an older graph */
+	const UDMGalaxyGraphSubsystem* UpdateCache();
+
+	/** Build the all pairs table if the galaxy is small enough and it isn't built yet; returns HasAllPairsTable */
+	bool BuildAllPairsTable(const UDMGalaxyGraphSubsystem& Graph);
+
+	/** Hop count from Start to every node, by graph index; INDEX_NONE where unreachable */
+	static void BreadthFirst(const UDMGalaxyGraphSubsystem& Graph, int32 Start, TArray<int32>& OutDistances);
+
+	/** A* from Start to Goal; straight line distance over the longest edge never overestimates the hops left */
+	bool AStar(const UDMGalaxyGraphSubsystem& Graph, int32 Start, int32 Goal, TArray<int32>& OutPath) const;
+
+	/** Distance lookup in the all pairs table */
+	int32 GetTableDistance(int32 From, int32 To) const;
+
+	/** Graph generation everything below was built for */
+	uint32 CachedGeneration = 0;
+
+	/** Node locations by graph index, and the longest edge; used by the A* heuristic */
+	TArray<FVector> NodeLocations;
+	double MaxEdgeLength = 0.0;
+
+	/** Row major hop counts, NumNodes x NumNodes; empty when the galaxy is too big, or until first needed */
+	TArray<uint16> AllPairs;
+
+	/** BuildAllPairsTable already ran for CachedGeneration; AllPairs stays empty if the galaxy was too big */
+	bool bAllPairsChecked = false;
+
+	/** Reachability sets by (start node, max moves, team) */
+	TMap<FIntVector, TBitArray<>> ReachableCache;
+
+	/** Graph blocking generation ReachableCache was built for */
+	uint32 CachedBlockingGeneration = 0;
+};
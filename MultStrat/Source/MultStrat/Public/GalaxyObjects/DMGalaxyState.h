@@ -0,0 +1,167 @@
+// Copyright (c) 2025 William Pritz under MIT License
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/DMTeamComponent.h"		// EDMPlayerTeam
+
+/**
+ * Actor free copy of everything turn resolution needs, one array per field
+ *
+ * Nodes, ships, moves and edges are plain indices; nothing in here points at
+ *		an actor, so a state can be resolved off the game thread, cloned for AI
+ *		lookahead, or built by hand for tests. Ship moves go through the same
+ *		edge reservation (bounce) rules as UDMNodeConnectionComponent.
+ *
+ * This is the only place the combat rules live. UDMPlanetProcessingSubsystem
+ *		captures every turn's combat into a state, resolves it here, and the
+ *		nodes just apply the results (ADMGalaxyNode::ApplyTurnResult).
+ *
+ * Usage:
+ *		AddNode/AddShip to describe the galaxy, SetNumEdges/AddMoveAlongEdge (or
+ *		AddMove for moves that already reserved their edge), then BuildRegions
+ *		and ResolveRegion for each region (concurrently if you like), or just
+ *		Resolve. Afterwards Regions lists every node in resolve order, and
+ *		NodeResults holds what happened at each one; that is the diff to apply
+ *		back to the actors.
+ */
+struct MULTSTRAT_API FDMGalaxyState
+{
+	static constexpr int32 NumTeams = (int32)EDMPlayerTeam::Count;
+
+	/** Combat at one node; indexed by node */
+	struct FNodeResult
+	{
+		/** Main attacking ship per team; INDEX_NONE if the team is only supporting */
+		int32 Ships[NumTeams];
+
+		/** Total power of each team's fleet */
+		int32 Powers[NumTeams];
+
+		/** One bit per team that has any ship involved */
+		uint32 InvolvedTeams = 0;
+
+		/** Invalid on a tie, or when the node saw no combat */
+		EDMPlayerTeam Winner = EDMPlayerTeam::Invalid;
+
+		bool IsInvolved(int32 Team) const	{ return (InvolvedTeams & (1u << (uint32)Team)) != 0; }
+
+		/**
+		 * Set Winner to the strongest team with an attacking ship; Invalid on a tie
+		 * returns how far ahead of the next team the winner is (0 on a tie)
+		 */
+		int32 FindWinner();
+	};
+
+	//~=============================================================================
+	// Setup
+
+	/** Add a node; returns its index. bTakesShipTeam: the node changes owner to the team of the ship docked at it (planets) */
+	int32 AddNode(EDMPlayerTeam Owner, bool bTakesShipTeam);
+
+	/** Add a ship docked at Node (may be INDEX_NONE); returns its index */
+	int32 AddShip(EDMPlayerTeam Team, int32 Power, int32 Node);
+
+	/** Edges are indexed 0 to NumEdges - 1; clears their reservations */
+	void SetNumEdges(int32 NumEdges);
+
+	/**
+	 * Move a ship along an edge towards Target, reserving the edge
+	 * If another ship already reserved the edge both ships bounce: neither moves. Returns false on a bounce.
+	 */
+	bool AddMoveAlongEdge(int32 Ship, int32 Target, int32 Edge);
+
+	/** Add a move with no reservation; a supporting ship adds its power without moving */
+	void AddMove(int32 Ship, int32 Target, bool bSupporting);
+
+	int32 NumNodes() const		{ return NodeOwner.Num(); }
+	int32 NumShips() const		{ return ShipTeam.Num(); }
+
+	//~=============================================================================
+	// Resolution
+
+	/** Group pending moves by target and split the nodes with combat into independent regions */
+	void BuildRegions();
+
+	/** Resolve every node in one region; regions share no nodes or ships, so they may resolve concurrently */
+	void ResolveRegion(int32 RegionIndex);
+
+	/** BuildRegions, then resolve every region on this thread */
+	void Resolve();
+
+	/** A node can resolve now if its docked ship leaving or staying can't change the result */
+	bool CanResolve(int32 Node);
+
+	/** Every team's main attacking ship and total power at a node, and the winner; OutMargin is how far ahead the winner is */
+	void GetPendingPowers(int32 Node, FNodeResult& OutResult, int32& OutMargin) const;
+
+	//~=============================================================================
+	// Nodes
+
+	TArray<EDMPlayerTeam> NodeOwner;
+	TArray<bool> NodeTakesShipTeam;
+
+	/** Ship docked at each node, INDEX_NONE if empty */
+	TArray<int32> NodeShip;
+
+	/** Range of each node's pending moves in PendingShip/PendingSupporting; built by BuildRegions */
+	TArray<int32> NodeFirstPending;
+	TArray<int32> NodeNumPending;
+
+	TArray<FNodeResult> NodeResults;
+
+	/** How far ahead each node's winner is; goes with NodeResults */
+	TArray<int32> NodeMargins;
+
+	//~=============================================================================
+	// Ships
+
+	TArray<EDMPlayerTeam> ShipTeam;
+	TArray<int32> ShipPower;
+
+	/** Node each ship is docked at, INDEX_NONE if none */
+	TArray<int32> ShipNode;
+
+	/** Plain bools rather than bit arrays; regions write them from different threads */
+	TArray<bool> ShipMoving;
+	TArray<bool> ShipAlive;
+
+	//~=============================================================================
+	// Moves, in the order they were added; cancelled moves have MoveShip INDEX_NONE
+
+	TArray<int32> MoveShip;
+	TArray<int32> MoveTarget;
+	TArray<bool> MoveSupporting;
+
+	//~=============================================================================
+	// Edges
+
+	/** Move holding each edge this turn, INDEX_NONE if free */
+	TArray<int32> EdgeReservation;
+
+	//~=============================================================================
+	// Built by BuildRegions
+
+	/** Pending moves grouped by target node, in the order they were added */
+	TArray<int32> PendingShip;
+	TArray<bool> PendingSupporting;
+
+	/** Nodes with combat in each region; in node order after BuildRegions, in resolve order after ResolveRegion */
+	TArray<TArray<int32>> Regions;
+
+private:
+	/** NodeResults[Node] is stale */
+	static constexpr int32 NodeResultUnset = -2;
+
+	/**
+	 * NodeResults[Node], worked out again only if the node's docked ship changed since (left, died or was replaced)
+	 * Nothing else GetPendingPowers reads changes while a turn resolves; OutMargin is how far ahead the winner is
+	 */
+	const FNodeResult& GetNodeResult(int32 Node, int32& OutMargin);
+
+	/** The loser is destroyed, and the winner leaves its home for this node */
+	void ResolveNode(int32 Node);
+
+	/** Live docked ship each node's cached result was worked out for (INDEX_NONE if none); NodeResultUnset if not worked out yet */
+	TArray<int32> NodeResultShip;
+};
@@ -22,6 +22,9 @@ public:
 	// Replication
 	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
+	/** Lockstep machines resolve ownership themselves; stop replicating it */
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
 	//~=============================================================================
 	// Ship Management
 
@@ -29,6 +32,12 @@ public:
 	void K2_SpawnShip(TSubclassOf<ADMShip> ShipType, EDMPlayerTeam Team);
 	void K2_SpawnShip_Implementation(TSubclassOf<ADMShip> ShipType, EDMPlayerTeam Team);
 
+	/**
+	 * Spawn a ship of the given type docked at this planet; returns nullptr if the planet already has a ship
+	 * Runs on the server, or on every machine in lockstep, where each machine spawns its own unreplicated ship
+	 */
+	ADMShip* SpawnShip(TSubclassOf<ADMShip> ShipType, EDMPlayerTeam Team);
+
 protected:
 
 	/** ADMGalaxyMode override; account for player ownership */
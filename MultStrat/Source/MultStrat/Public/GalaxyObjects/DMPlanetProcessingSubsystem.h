@@ -4,10 +4,14 @@
 
 #include "CoreMinimal.h"
 #include "Subsystems/WorldSubsystem.h"
+#include "GalaxyObjects/DMGalaxyState.h"		// FDMGalaxyState
 #include "DMPlanetProcessingSubsystem.generated.h"
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FTurnProcessingFinished);
 
+class ADMGalaxyNode;
+class ADMShip;
+
 /**
  * Used by local clients to process/animate the results of a turn
  * 
@@ -15,7 +19,7 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE(FTurnProcessingFinished);
  *		things like resolving one planet at a time or resolving planets every
  *		X seconds easier.
  */
-UCLASS()
+UCLASS(Config = Game)
 class MULTSTRAT_API UDMPlanetProcessingSubsystem : public UTickableWorldSubsystem
 {
 	GENERATED_BODY()
@@ -51,14 +55,48 @@ public:
 
 	/** Called when the subsystem should start moving/animating planets */
 	void StartProcessingPlanetResults();
+
+	/** Resolve whatever is left of the current turn right now, ignoring the frame budget; does nothing if no turn is processing */
+	void FinishProcessingTurn();
+
+	/** True from StartProcessingPlanetResults until every node has resolved its turn */
+	bool IsProcessingTurn() const	{ return bProcessingTurn; }
+
+	/** Nodes touched this turn (ships pending, ships placed); only these are visited when resolving */
+	void MarkNodeDirty(ADMGalaxyNode* Node);
+
+	/** Fraction of this turn's combats resolved so far, 0 to 1; 1 when no turn is processing */
+	UFUNCTION(BlueprintPure)
+	float GetCombatProgress() const;
+
+	/** XOR of every node's state hash; machines that agree on the galaxy agree on this */
+	uint32 GetGalaxyHash() const	{ return GalaxyHash; }
+
+	/** A node's state hash changed; swap the old one out of the galaxy hash for the new one */
+	void UpdateGalaxyHash(uint32 OldNodeHash, uint32 NewNodeHash)	{ GalaxyHash ^= OldNodeHash ^ NewNodeHash; }
 	
 protected:
 	/** Let the planets start moving their respective ships to them */
 	virtual void MovePendingShipsToPlanets();
 
-	/** Let the planets resolve their combat */
+	/** Let the planets resolve their combat in move dependency order; clients may spread the work over several frames */
 	virtual void ProcessPlanetCombat();
 
+	/** Collect the dirty nodes with combat this turn, in resolve order */
+	void GatherCombatNodes();
+
+	/** Start copying the turn into CombatState: add every combat node */
+	void BeginCombatCapture();
+
+	/** Copy one combat node's docked ship and pending moves into CombatState */
+	void CaptureCombatNode(int32 NodeIndex);
+
+	/** Resolve the next regions of CombatState (a batch on worker threads for large turns, all of them without a budget) and line up their results */
+	void ResolveCombatRegions(bool bUseBudget);
+
+	/** Apply one node's result from CombatState to the actors */
+	void ApplyCombatResult(int32 NodeIndex);
+
 	/** Clean up. Tell the game state we're all done processing. */
 	virtual void ProcessingFinished();
 
@@ -70,4 +108,72 @@ protected:
 
 	EProcessingStage CurrentStage = EProcessingStage::MoveShips;
 
+	bool bProcessingTurn = false;
+
+	/** Game state turn number when this turn started processing; the next turn's commands may bump it before we finish */
+	int32 ProcessingTurnNumber = 0;
+
+	/**
+	 * Max time clients spend on combat each frame (capturing, resolving, applying), in milliseconds; the rest carries over
+	 * 0 does the whole turn in one frame. Servers always do it in one frame.
+	 */
+	UPROPERTY(Config)
+	float ClientCombatFrameBudgetMs = 2.0f;
+
+	/** Resolve combat regions on worker threads */
+	UPROPERTY(Config)
+	bool bParallelCombatResolution = true;
+
+	/** Turns with fewer combats than this resolve on the game thread; not worth the copy */
+	UPROPERTY(Config)
+	int32 ParallelCombatMinNodes = 64;
+
+	/** Regions clients hand to the worker threads at once between frame budget checks */
+	UPROPERTY(Config)
+	int32 ClientCombatRegionBatch = 32;
+
+	/** Set while FinishProcessingTurn runs the turn to completion */
+	bool bIgnoreFrameBudget = false;
+
+	//~=============================================================================
+	// Combat resolution state; kept between ticks so resolution can pick up where it left off
+
+	/** Dirty nodes with combat this turn, in resolve order; also the node indices of CombatState */
+	UPROPERTY()
+	TArray<TObjectPtr<ADMGalaxyNode>> CombatNodes;
+
+	/** Ship actors by CombatState ship index */
+	UPROPERTY()
+	TArray<TObjectPtr<ADMShip>> CombatShips;
+
+	/** This turn's combat, copied from the actors and resolved before any result is applied */
+	FDMGalaxyState CombatState;
+
+	/** CombatState index of each node and ship copied so far; not UPROPERTYs, CombatNodes and CombatShips keep them alive */
+	TMap<const ADMGalaxyNode*, int32> CaptureNodeIndices;
+	TMap<const ADMShip*, int32> CaptureShipIndices;
+
+	/** Next CombatNodes index to copy into CombatState */
+	int32 CaptureCursor = 0;
+
+	bool bRegionsBuilt = false;
+
+	/** Next CombatState region to resolve */
+	int32 RegionCursor = 0;
+
+	/** CombatNodes indices in the order their results are applied, and how far into them we are */
+	TArray<int32> ApplyOrder;
+	int32 ApplyCursor = 0;
+
+	int32 NumCombats = 0;
+	int32 NumUnresolvedCombats = 0;
+	bool bCombatStarted = false;
+
+	/** Nodes touched since the last turn finished processing */
+	UPROPERTY()
+	TSet<TObjectPtr<ADMGalaxyNode>> DirtyNodes;
+
+	/** Kept up to date by the nodes as they change, so reading it is free */
+	uint32 GalaxyHash = 0;
+
 };
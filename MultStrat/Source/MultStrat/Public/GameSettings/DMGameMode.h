@@ -47,6 +47,19 @@ public:
 	float ShipSpawnZOffset = 50.0f;
 };
 
+/**
+ * Inactive ships of a single class waiting to be rebuilt
+ * Wrapped in a struct so the pools can be a UPROPERTY (stops garbage collection)
+ */
+USTRUCT()
+struct MULTSTRAT_API FDMShipPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<TObjectPtr<ADMShip>> Ships;
+};
+
 
 /**
  * DedMults gamemode. Go to location for managing player connections and
@@ -63,7 +76,7 @@ public:
 	/** set up ADMGameState too */
 	virtual void InitGameState() override;
 
-	/** Check max # of players before allowing a login */
+	/** Check max # of players before allowing a login; lockstep games can't be joined once the first turn has run */
 	virtual void PreLogin(const FString& Options, const FString& Address, const FUniqueNetIdRepl& UniqueId, FString& ErrorMessage) override;
 
 	/** Register the new player to the ADMGameState */
@@ -96,6 +109,21 @@ public:
 	/** Check the Command data asset for the default ship spawn Z offset */
 	float GetShipSpawnZOffset() const;
 
+	//~=============================================================================
+	// Ship Pooling
+
+	/**
+	 * Get an active ship of the given class; reuses a pooled ship when one is available
+	 * The caller sets its team and owner and docks it at a node
+	 */
+	ADMShip* AcquireShip(TSubclassOf<ADMShip> ShipClass);
+
+	/**
+	 * Deactivate and hide a ship (i.e. lost in combat) so a future build can reuse it
+	 * Ships are only destroyed once the pool is full
+	 */
+	void ReleaseShip(ADMShip* Ship);
+
 private:
 
 	/** Max # of players allowed in this game mode */
@@ -112,5 +140,23 @@ private:
 	/** Default values for command-related data (i.e default ship to build) */
 	UPROPERTY(EditDefaultsOnly, Category = "DedMult Defaults")
 	TObjectPtr<UCommandsDataAsset> CommandsDataAsset;
+
+	/**
+	 * Lockstep: the server only sends each turn's ordered commands, and every machine resolves the turn itself
+	 * Galaxy results (ships, node ownership) are no longer replicated per actor, so players can't join mid-game
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "DedMult Defaults")
+	bool bLockstepTurns = false;
+
+	/** Most inactive ships kept around for reuse, over all ship classes; ships released past this are destroyed */
+	UPROPERTY(EditDefaultsOnly, Category = "DedMult Defaults")
+	int32 MaxPooledShips = 256;
+
+	/** Inactive ships, per ship class */
+	UPROPERTY(Transient)
+	TMap<TSubclassOf<ADMShip>, FDMShipPool> ShipPools;
+
+	/** # of ships in all of ShipPools */
+	int32 NumPooledShips = 0;
 	
 };
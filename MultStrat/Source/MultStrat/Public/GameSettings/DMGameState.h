@@ -4,13 +4,29 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameState.h"
+#include "Commands/DMCommand.h"		// FCommandTurnPacket
 #include "DMGameState.generated.h"
 
 class ADMPlayerState;
+class ADMShip;
+class UCommandsDataAsset;
 class UDMCommand;
 class UTeamDataAsset;
 enum class EDMPlayerTeam : uint8;
 
+/** Galaxy hash once a turn has fully resolved */
+USTRUCT()
+struct FDMTurnHash
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 Turn = 0;
+
+	UPROPERTY()
+	uint32 Hash = 0;
+};
+
 /**
  * DMGameState is responsible for managing players and their teams
  * 
@@ -50,6 +66,34 @@ public:
 	UFUNCTION(BlueprintCallable)
 	bool IsProcessingATurn()		{ return bTurnProcessing; }
 
+	//~=============================================================================
+	// Lockstep
+
+	/** True if every machine resolves turns itself from the server's commands; see ADMGameMode::bLockstepTurns */
+	static bool IsLockstep(UObject* WorldContextObject);
+
+	/**
+	 * Server sends the turn's validated commands, in execution order, to every client to run locally
+	 * Ships are sent by the node they're docked at, so they don't need to be replicated actors
+	 */
+	UFUNCTION(NetMulticast, Reliable)
+	void MulticastTurnCommands(int32 Turn, const FCommandTurnPacket& TurnPacket);
+	void MulticastTurnCommands_Implementation(int32 Turn, const FCommandTurnPacket& TurnPacket);
+
+	//~=============================================================================
+	// Desync Detection
+
+	/** Called by planet processing once a turn has fully resolved; the server publishes its hash, clients check theirs. Lockstep only */
+	void TurnResolved(int32 Turn, uint32 GalaxyHash);
+
+	/** Turns the server has executed so far */
+	UFUNCTION(BlueprintPure)
+	int32 GetTurnNumber() const		{ return TurnNumber; }
+
+	/** First turn this client's galaxy didn't match the server's; INDEX_NONE while in sync, and always outside lockstep */
+	UFUNCTION(BlueprintPure)
+	int32 GetFirstDivergentTurn() const		{ return FirstDivergentTurn; }
+
 	//~=============================================================================
 	// Player Metadata Management
 
@@ -68,10 +112,24 @@ public:
 	UFUNCTION(BlueprintCallable)
 	ADMPlayerState* GetPlayerForTeam(EDMPlayerTeam Team);
 
+	/** Check the command data asset for the default ship class; works on clients too */
+	TSubclassOf<ADMShip> GetDefaultShip() const;
+
+	/** Check the command data asset for the default ship spawn Z offset; works on clients too */
+	float GetShipSpawnZOffset() const;
+
 	/** Pointer to team data asset, initialized from ADMGameMode on startup */
 	UPROPERTY(Transient, Replicated)
 	TObjectPtr<UTeamDataAsset> CurrentTeamData;
 
+	/** Pointer to command data asset, initialized from ADMGameMode on startup; clients need it to run commands in lockstep */
+	UPROPERTY(Transient, Replicated)
+	TObjectPtr<UCommandsDataAsset> CurrentCommandsData;
+
+	/** Initialized from ADMGameMode on startup */
+	UPROPERTY(Replicated)
+	bool bLockstepTurns = false;
+
 	/** When a player joins, they will be given this team */
 	UPROPERTY(Replicated)
 	EDMPlayerTeam NextNewTeam;
@@ -85,5 +143,30 @@ protected:
 	UPROPERTY(Replicated, ReplicatedUsing = OnRep_TurnProcessing)
 	bool bTurnProcessing;
 
+	/** Compare the server's hashes against ours for the same turns, once we have both */
+	UFUNCTION()
+	void OnRep_ServerTurnHashes();
+	void CompareTurnHashes();
+
+	/** Incremented by the server before each turn's commands execute */
+	UPROPERTY(Replicated)
+	int32 TurnNumber = 0;
+
+	/** How many of the server's latest turn hashes are kept; a client that resolves a turn later than this misses its check */
+	static constexpr int32 NumServerTurnHashes = 8;
+
+	/**
+	 * Server's galaxy hashes for the last turns it resolved, oldest first
+	 * More than one, since replication may skip values and a client may
+	 *		resolve a turn after the server has moved on to the next one
+	 */
+	UPROPERTY(Replicated, ReplicatedUsing = OnRep_ServerTurnHashes)
+	TArray<FDMTurnHash> ServerTurnHashes;
+
+	/** Client's own hash for each resolved turn that hasn't been compared with the server's yet */
+	TMap<int32, uint32> LocalTurnHashes;
+
+	int32 FirstDivergentTurn = INDEX_NONE;
+
 private:
 };
@@ -0,0 +1,96 @@
+// Copyright (c) 2025 William Pritz under MIT License
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UDMCommand;
+enum class EDMPlayerTeam : uint8;
+
+/** Everything the turn event log knows how to record */
+enum class EDMTurnEventType : uint8
+{
+	CommandRegistered,		// Subject: player,		Target: target node,	Context: command,		Ship: command's ship,	Value: priority
+	CommandExecuted,		// Subject: player,		Target: target node,	Context: command,		Ship: command's ship,	Team: player's team
+	CommandCancelled,		// Subject: player,		Target: target node,	Context: command,		Ship: command's ship
+	CommandsCancelled,		// Subject: player,		Value: # of commands cancelled
+	ShipsBounced,			// Subject: reserving ship,	Target: target node,	Context: ship already on the connector
+	CombatStarted,			// Subject: node,		Team: previous owner
+	CombatAttacker,			// Subject: node,		Team: attacker,			Value: power
+	CombatSupportOnly,		// Subject: node,		Team: supporter,		Value: power
+	CombatWinner,			// Subject: node,		Target: winning ship,	Team: winner
+	CombatNoWinner,			// Subject: node
+	TeamChanged,			// Subject: actor,		Team: new team
+};
+
+/**
+ * One compact turn event
+ * Only names, a team and a number are stored; nothing is turned into a string
+ *		until a sink actually wants the text (see FDMTurnEventLog::Flush)
+ */
+struct MULTSTRAT_API FDMTurnEvent
+{
+	EDMTurnEventType Type = EDMTurnEventType::CommandRegistered;
+	EDMPlayerTeam Team = (EDMPlayerTeam)0;
+	int32 Value = 0;
+	FName Subject;
+	FName Target;
+	FName Context;
+
+	/** Ship a command acts on; None for events without one */
+	FName Ship;
+
+	/** Human readable version of the event, matching our old log lines */
+	FString ToString() const;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FDMTurnEventSink, const FDMTurnEvent&);
+
+/**
+ * Structured event channel for turn processing
+ *
+ * Hot turn code (command registration/execution, combat, team changes) records
+ *		small binary events into a ring buffer instead of building log strings.
+ *		Events are handed to the sinks when the buffer is flushed (end of command
+ *		execution, end of planet processing, or when the buffer fills up) and are
+ *		only formatted for the log categories that aren't suppressed.
+ *
+ * One log per world, owned by UDMCommandQueueSubsystem. Game thread only.
+ */
+class MULTSTRAT_API FDMTurnEventLog
+{
+public:
+	/**
+	 * The log of the world WorldContextObject is in; each world's UDMCommandQueueSubsystem owns one, so PIE
+	 *		servers and clients don't flush each other's events. Objects outside a game world share a fallback log.
+	 */
+	static FDMTurnEventLog& Get(const UObject* WorldContextObject);
+
+	/** Record an event; objects are stored by name only */
+	void Record(EDMTurnEventType Type, EDMPlayerTeam Team, const UObject* Subject, const UObject* Target = nullptr, const UObject* Context = nullptr, int32 Value = 0);
+
+	/** Record a command event: its player (and their team), target node, the command itself and its ship */
+	void RecordCommand(EDMTurnEventType Type, const UDMCommand* Command, int32 Value = 0);
+
+	/** Hand every buffered event to the log and any bound sinks, then empty the buffer */
+	void Flush();
+
+	/** Native sinks; receive the raw events when the log is flushed */
+	FDMTurnEventSink OnEventFlushed;
+
+private:
+	/** Max events held between flushes; the buffer flushes itself when full */
+	static constexpr int32 Capacity = 4096;
+
+	/** Write the event to its log category, if that category would print it */
+	static void LogEvent(const FDMTurnEvent& Event);
+
+	/** Ring buffer of events; allocated on first use */
+	TArray<FDMTurnEvent> Events;
+
+	/** Index of the oldest buffered event */
+	int32 Head = 0;
+
+	/** Number of buffered events */
+	int32 Count = 0;
+};
@@ -0,0 +1,41 @@
+// Copyright (c) 2025 William Pritz under MIT License
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.h"
+
+/**
+ * Unreal Insights instrumentation for turn processing
+ *
+ * Every stage of a turn (command registration, priority ordering, validation,
+ *		running commands, combat resolution, cleanup) opens a scoped timer on the
+ *		DMTurn channel; enable it with -trace=cpu,counters,DMTurn (or
+ *		"Trace.Enable DMTurn" at runtime). The counters hold the totals for the
+ *		turn currently being processed and are reset when a new turn starts.
+ *
+ * Everything here compiles away in builds without trace support.
+ */
+
+UE_TRACE_CHANNEL_EXTERN(DMTurnChannel, MULTSTRAT_API)
+
+/** Scoped timer on the DMTurn channel; shows up in Insights as "DMTurn::<Name>" */
+#define DM_TURN_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("DMTurn::" #Name, DMTurnChannel)
+
+TRACE_DECLARE_INT_COUNTER_EXTERN(DMTurn_CommandsRun);
+TRACE_DECLARE_INT_COUNTER_EXTERN(DMTurn_CommandsInvalidated);
+TRACE_DECLARE_INT_COUNTER_EXTERN(DMTurn_CombatIterations);
+TRACE_DECLARE_INT_COUNTER_EXTERN(DMTurn_Combats);
+TRACE_DECLARE_INT_COUNTER_EXTERN(DMTurn_Bounces);
+TRACE_DECLARE_INT_COUNTER_EXTERN(DMTurn_OwnershipChanges);
+
+/** Zero every per-turn counter; called when a turn starts executing */
+#define DM_TURN_TRACE_RESET_COUNTERS() \
+	TRACE_COUNTER_SET(DMTurn_CommandsRun, 0); \
+	TRACE_COUNTER_SET(DMTurn_CommandsInvalidated, 0); \
+	TRACE_COUNTER_SET(DMTurn_CombatIterations, 0); \
+	TRACE_COUNTER_SET(DMTurn_Combats, 0); \
+	TRACE_COUNTER_SET(DMTurn_Bounces, 0); \
+	TRACE_COUNTER_SET(DMTurn_OwnershipChanges, 0)
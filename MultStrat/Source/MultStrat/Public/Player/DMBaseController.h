@@ -9,7 +9,7 @@
 
 class UDMCommand;
 class ADMGameState;
-struct FCommandPacket;
+struct FCommandTurnPacket;
 
 /**
  * Base controller for all Commanders in the game
@@ -39,15 +39,16 @@ public:
 	bool CancelCommand(UDMCommand* Command);
 	
 	/**
-	 * Queue a Command in the Command Queue Subsystem
+	 * Queue a turn's worth of Commands in the Command Queue Subsystem
 	 * Run on the server because thats where the subsystem is
+	 * The whole turn is packed into a single FCommandTurnPacket so it goes out in one RPC
 	 *
 	 * DMTODO: Client simulation means we need this to not be a server command, but set up the game
 	 * to simulate in case we are not on the server!
 	 */
 	UFUNCTION(Reliable, Server)
-	void QueueCommandsOnServer(const TArray<FCommandPacket>& CommandInfo);
-	void QueueCommandsOnServer_Implementation(const TArray<FCommandPacket>& CommandInfo);
+	void QueueCommandsOnServer(const FCommandTurnPacket& TurnPacket);
+	void QueueCommandsOnServer_Implementation(const FCommandTurnPacket& TurnPacket);
 
 	//~=============================================================================
 	// Turn Management
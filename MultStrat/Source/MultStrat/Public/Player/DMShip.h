@@ -36,6 +36,16 @@ public:
 	bool IsNodeReachable(const ADMGalaxyNode* TargetNode) const;
 	virtual bool IsNodeReachable_Implementation(const ADMGalaxyNode* TargetNode) const;
 
+	/**
+	 * Every node this ship could reach within MaxMoves moves, one bit per galaxy graph index
+	 * See UDMGalaxyPathfindingSubsystem::GetReachableNodes; cached, so asking again for a selected ship is free
+	 */
+	TBitArray<> GetReachableNodes(int32 MaxMoves) const;
+
+	UFUNCTION(BlueprintCallable, BlueprintPure,
+		meta = (ToolTip = "Returns true if the target node can be reached within MaxMoves movement commands.\nRoutes don't pass through nodes holding another team's ship.\nNote: Returns false if the target node is the ships current node."))
+	bool IsNodeReachableWithin(const ADMGalaxyNode* TargetNode, int32 MaxMoves) const;
+
 	UFUNCTION(BlueprintCallable)
 	ADMPlayerState* GetOwningPlayer()					{ return OwningPlayer; }
 	UFUNCTION(BlueprintCallable)
@@ -44,6 +54,19 @@ public:
 
 	int GetShipPower() const							{ return ShipPower;}
 
+	//~=============================================================================
+	// Pooling
+
+	/** Inactive ships are hidden in the game mode's ship pool; they can't be given commands */
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	bool IsShipActive() const							{ return bShipActive; }
+
+	/** Bring a pooled ship back; its team and owner are set by whoever built it */
+	void ActivateShip();
+
+	/** Undock, hide and clear the ship so it can wait in the pool */
+	void DeactivateShip();
+
 protected:
 
 	/** Player that owns the ship for debug/possibility of alliances in the future */
@@ -53,5 +76,9 @@ protected:
 	/** Power of the ship used for Attacking/Supporting other nodes */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	int ShipPower = 1;
+
+	/** False while the ship sits in the game mode's ship pool */
+	UPROPERTY(Replicated)
+	bool bShipActive = true;
 	
 };